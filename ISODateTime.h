@@ -1,12 +1,190 @@
 #ifndef ISODATETIME_LIBRARY_H
 #define ISODATETIME_LIBRARY_H
 
+#include <array>
 #include <string>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <string_view>
+
+// Define ISODATETIME_HEADER_ONLY (or link ISODateTime::header_only) to compile the whole
+// implementation inline into each user instead of linking the static library
+#if defined(ISODATETIME_HEADER_ONLY)
+#define ISODATETIME_INLINE inline
+#else
+#define ISODATETIME_INLINE
+#endif
+
+// Parsed tzdata behind ISODateTime::TimeZone, defined in ISODateTimeImpl.h
+namespace isodatetime_detail {
+struct time_zone;
+} // namespace isodatetime_detail
 
 class ISODateTime {
     public:
+    // Proleptic Gregorian calendar date
+    struct CivilDate {
+        std::int64_t year;
+        unsigned month; // 1-12
+        unsigned day; // 1-31
+    };
+
+    // ISO 8601 week date: week-numbering year, week 1-53, weekday 1 (Monday) - 7 (Sunday)
+    struct WeekDate {
+        std::int64_t year;
+        unsigned week;
+        unsigned weekday;
+    };
+
+    // Output formats selectable at runtime; each matches the get_current_* function of the same name, where there is one
+    enum class Format : std::uint8_t {
+        iso_date,
+        iso_date_time,
+        iso_date_timestamp,
+        iso_date_timestamp_us,
+        iso_date_timestamp_ns,
+        utc_iso_date,
+        utc_iso_date_time,
+        utc_iso_date_timestamp,
+        utc_iso_date_timestamp_us,
+        utc_iso_date_timestamp_ns,
+        iso_date_time_offset,
+        iso_date_timestamp_offset,
+        iso_date_timestamp_us_offset,
+        iso_date_timestamp_ns_offset,
+    };
+
+    // Fixed-capacity formatted text: trivially copyable, memcpy-able, never touches the heap
+    struct IsoStamp {
+        char data[40]; // null-terminated
+        std::uint8_t length;
+
+        [[nodiscard]] constexpr std::string_view view() const noexcept { return {data, length}; }
+        [[nodiscard]] constexpr const char* c_str() const noexcept { return data; }
+        [[nodiscard]] std::string str() const { return {data, length}; }
+        constexpr operator std::string_view() const noexcept { return view(); }
+    };
+
+    static constexpr std::size_t format_count = static_cast<std::size_t>(Format::iso_date_timestamp_ns_offset) + 1; // Number of Format values
+
+    // Hot-path counters, collected only when built with ISODATETIME_ENABLE_INSTRUMENTATION (otherwise always zero)
+    struct Counters {
+        std::uint64_t calls_by_format[format_count]; // format_current_* / get_current_* / format / stamp calls, indexed by Format
+        std::uint64_t week_date_calls; // format_current_* / get_current_* week dates, local and UTC (no Format of their own)
+        std::uint64_t ordinal_date_calls; // format_current_* / get_current_* ordinal dates, local and UTC
+        std::uint64_t batch_records; // records given to format_batch and format_compact_batch
+        std::uint64_t plan_calls; // format / stamp through a FormatPlan
+        std::uint64_t zoned_calls; // format / stamp in a TimeZone
+        std::uint64_t compact_captures; // capture_compact
+        std::uint64_t parse_calls; // parse_iso, parse_utc_iso and records given to parse_utc_iso_timestamps
+        std::uint64_t ticker_reads; // timestamps served from the ticker
+        std::uint64_t clock_reads; // reads of the selected ClockSource
+        std::uint64_t monotonic_clamps; // reads raised to just past the MonotonicMode high-water mark
+        std::uint64_t second_cache_hits; // per-thread seconds cache
+        std::uint64_t second_cache_misses;
+        std::uint64_t date_cache_hits; // process-wide daily date cache
+        std::uint64_t date_cache_misses;
+        std::uint64_t offset_table_hits; // local offset cache lookups (when enabled)
+        std::uint64_t offset_table_misses;
+        std::uint64_t zone_index_hits; // TimeZone lookups served by the last transition used
+        std::uint64_t zone_index_misses;
+        std::uint64_t tm_conversion_ns; // time in resolve_local_tm / to_utc_tm on seconds-cache misses
+        std::uint64_t rendering_ns; // time rendering the date/time prefix on seconds-cache misses
+    };
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+    static constexpr bool instrumentation_enabled = true;
+#else
+    static constexpr bool instrumentation_enabled = false;
+#endif
+
+    // Longest text a FormatPlan may produce, so every plan fits an IsoStamp
+    static constexpr std::size_t format_plan_max_length = 39;
+
+    // Custom pattern compiled once by compile_format into fixed-width field writers; immutable and safe to share across threads
+    struct FormatPlan {
+        enum class Field : std::uint8_t {
+            prefix, // slice of the cached YYYY-MM-DDTHH:MM:SS text
+            fraction, // leading width digits of the nanoseconds
+            day_of_year, // 001-366
+            weekday, // 1 (Monday) - 7 (Sunday)
+            offset, // +HHMM
+            offset_colon, // +HH:MM
+        };
+        struct Step {
+            Field field;
+            std::uint8_t out; // position in the output
+            std::uint8_t source; // position in the cached prefix (Field::prefix only)
+            std::uint8_t width; // bytes written
+        };
+        char text[format_plan_max_length]; // literal characters at their output positions
+        Step steps[format_plan_max_length];
+        std::uint8_t step_count;
+        std::uint8_t length; // bytes written by format
+        bool utc; // render UTC (true) or local (false) wall-clock fields
+    };
+
+    // Compact captured time: render later with format/stamp; serialises to compact_time_length bytes
+    struct CompactTime {
+        std::int64_t nanoseconds; // since 1970-01-01T00:00:00Z
+        std::int8_t offset_quarters; // local UTC offset at capture in 15-minute units, or compact_unknown_offset
+    };
+    static constexpr std::int8_t compact_unknown_offset = -128; // local offset was not a whole number of quarter hours
+    static constexpr std::size_t compact_time_length = 9; // nanoseconds (8 bytes, little-endian) + offset byte
+
+    // A time and the Format to render it in, captured on the hot path and formatted later (e.g. on a logger thread)
+    struct DeferredStamp {
+        std::chrono::time_point<std::chrono::system_clock> time_point;
+        Format format;
+    };
+
+    // A time_point to print with std::format / fmt ("{:utc_timestamp}"); formatters are in ISODateTimeFormatter.h
+    struct IsoTime {
+        std::chrono::time_point<std::chrono::system_clock> time_point;
+    };
+
+    // A time interval, written by format_iso_interval as start/end
+    struct Interval {
+        std::chrono::time_point<std::chrono::system_clock> start;
+        std::chrono::time_point<std::chrono::system_clock> end;
+    };
+
+    // Clock read by the no-argument functions
+    enum class ClockSource : std::uint8_t {
+        system, // std::chrono::system_clock::now()
+        realtime_coarse, // Linux CLOCK_REALTIME_COARSE (kernel tick resolution, typically 1-4 ms); system elsewhere
+        tsc, // Calibrated x86 invariant TSC anchored to system_clock; system where unavailable
+    };
+
+    // Ordering guarantee for the times read by the no-argument functions
+    enum class MonotonicMode : std::uint8_t {
+        off, // whatever the ClockSource returns, including steps back under NTP or a leap second
+        per_thread, // each read on a thread is strictly later than that thread's previous read
+        global, // each read is strictly later than every earlier read in the process (one shared atomic)
+    };
+
+    // Handle to an IANA time zone from load_zone; trivially copyable and valid until the process exits
+    struct TimeZone {
+        const isodatetime_detail::time_zone* data;
+    };
+
+    // How rewrite_log_timestamps finds and processes timestamps
+    static constexpr std::size_t scan_for_timestamp = static_cast<std::size_t>(-1); // LogRewriteOptions::column: search each line
+    struct LogRewriteOptions {
+        std::size_t column; // byte offset of the timestamp in every line, or scan_for_timestamp
+        unsigned threads; // worker threads; 0 for hardware_concurrency
+        std::size_t chunk_size; // bytes of input per work item, rounded up to a line end
+    };
+
+    // Outcome of rewrite_log_timestamps
+    struct LogRewriteResult {
+        bool ok; // false if a file could not be opened, mapped or written
+        std::uint64_t lines;
+        std::uint64_t converted; // timestamps rewritten to UTC
+        std::uint64_t bytes_written;
+    };
+
     // Prevent instantiation
     ISODateTime() = delete;
     ~ISODateTime() = default;
@@ -27,11 +205,660 @@ class ISODateTime {
     [[nodiscard]] static std::string get_current_utc_iso_date_time(); // Get current ISO Date and Time
     [[nodiscard]] static std::string get_current_utc_iso_date_timestamp(); // Get current ISO Date and Timestamp
 
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_us(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current ISO Date and Timestamp with Microseconds from a time_point
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_ns(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current ISO Date and Timestamp with Nanoseconds from a time_point
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_us(); // Get current ISO Date and Timestamp with Microseconds
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_ns(); // Get current ISO Date and Timestamp with Nanoseconds
+
+    [[nodiscard]] static std::string get_current_utc_iso_date_timestamp_us(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current UTC ISO Date and Timestamp with Microseconds from a time_point
+    [[nodiscard]] static std::string get_current_utc_iso_date_timestamp_ns(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current UTC ISO Date and Timestamp with Nanoseconds from a time_point
+    [[nodiscard]] static std::string get_current_utc_iso_date_timestamp_us(); // Get current UTC ISO Date and Timestamp with Microseconds
+    [[nodiscard]] static std::string get_current_utc_iso_date_timestamp_ns(); // Get current UTC ISO Date and Timestamp with Nanoseconds
+
+    [[nodiscard]] static std::string get_current_iso_date_time_offset(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current ISO Date and Time with UTC offset from a time_point
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_offset(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get current ISO Date and Timestamp with UTC offset from a time_point
+    [[nodiscard]] static std::string get_current_iso_date_time_offset(); // Get current ISO Date and Time with UTC offset
+    [[nodiscard]] static std::string get_current_iso_date_timestamp_offset(); // Get current ISO Date and Timestamp with UTC offset
+
+    [[nodiscard]] static std::string get_current_iso_week_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get ISO Week Date (YYYY-Www-D) from a time_point
+    [[nodiscard]] static std::string get_current_iso_ordinal_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get ISO Ordinal Date (YYYY-DDD) from a time_point
+    [[nodiscard]] static std::string get_current_utc_iso_week_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get UTC ISO Week Date from a time_point
+    [[nodiscard]] static std::string get_current_utc_iso_ordinal_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&); // Get UTC ISO Ordinal Date from a time_point
+    [[nodiscard]] static std::string get_current_iso_week_date(); // Get current ISO Week Date
+    [[nodiscard]] static std::string get_current_iso_ordinal_date(); // Get current ISO Ordinal Date
+    [[nodiscard]] static std::string get_current_utc_iso_week_date(); // Get current UTC ISO Week Date
+    [[nodiscard]] static std::string get_current_utc_iso_ordinal_date(); // Get current UTC ISO Ordinal Date
+
+    // Fixed lengths of the text written by the format_current_* functions
+    static constexpr std::size_t iso_date_length = 10; // YYYY-MM-DD
+    static constexpr std::size_t iso_date_time_length = 19; // YYYY-MM-DDTHH:MM:SS
+    static constexpr std::size_t iso_date_timestamp_length = 23; // YYYY-MM-DDTHH:MM:SS.mmm
+    static constexpr std::size_t utc_iso_date_length = 10; // YYYY-MM-DD
+    static constexpr std::size_t utc_iso_date_time_length = 20; // YYYY-MM-DDTHH:MM:SSZ
+    static constexpr std::size_t utc_iso_date_timestamp_length = 24; // YYYY-MM-DDTHH:MM:SS.mmmZ
+    static constexpr std::size_t iso_date_timestamp_us_length = 26; // YYYY-MM-DDTHH:MM:SS.ffffff
+    static constexpr std::size_t iso_date_timestamp_ns_length = 29; // YYYY-MM-DDTHH:MM:SS.fffffffff
+    static constexpr std::size_t utc_iso_date_timestamp_us_length = 27; // YYYY-MM-DDTHH:MM:SS.ffffffZ
+    static constexpr std::size_t utc_iso_date_timestamp_ns_length = 30; // YYYY-MM-DDTHH:MM:SS.fffffffffZ
+    static constexpr std::size_t iso_date_time_offset_length = 25; // YYYY-MM-DDTHH:MM:SS+HH:MM
+    static constexpr std::size_t iso_date_timestamp_offset_length = 29; // YYYY-MM-DDTHH:MM:SS.mmm+HH:MM
+    static constexpr std::size_t iso_date_timestamp_us_offset_length = 32; // YYYY-MM-DDTHH:MM:SS.ffffff+HH:MM
+    static constexpr std::size_t iso_date_timestamp_ns_offset_length = 35; // YYYY-MM-DDTHH:MM:SS.fffffffff+HH:MM
+    static constexpr std::size_t iso_week_date_length = 10; // YYYY-Www-D
+    static constexpr std::size_t iso_ordinal_date_length = 8; // YYYY-DDD
+    static constexpr std::size_t iso_duration_max_length = 29; // -P106751DT23H47M16.854775808S, the longest nanoseconds duration
+    static constexpr std::size_t iso_interval_max_length = 2 * iso_date_timestamp_ns_offset_length + 1; // start/end in the longest Format
+
+    [[nodiscard]] static std::size_t format_current_iso_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_time(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Time from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Timestamp from a time_point into a buffer
+
+    [[nodiscard]] static std::size_t format_current_iso_date(char*, std::size_t) noexcept; // Write current ISO Date into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_time(char*, std::size_t) noexcept; // Write current ISO Date and Time into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp(char*, std::size_t) noexcept; // Write current ISO Date and Timestamp into a buffer
+
+    [[nodiscard]] static std::size_t format_current_utc_iso_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_time(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Date and Time from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Date and Timestamp from a time_point into a buffer
+
+    [[nodiscard]] static std::size_t format_current_utc_iso_date(char*, std::size_t) noexcept; // Write current UTC ISO Date into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_time(char*, std::size_t) noexcept; // Write current UTC ISO Date and Time into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp(char*, std::size_t) noexcept; // Write current UTC ISO Date and Timestamp into a buffer
+
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_us(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Timestamp with Microseconds from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_ns(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Timestamp with Nanoseconds from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_us(char*, std::size_t) noexcept; // Write current ISO Date and Timestamp with Microseconds into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_ns(char*, std::size_t) noexcept; // Write current ISO Date and Timestamp with Nanoseconds into a buffer
+
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp_us(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Date and Timestamp with Microseconds from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp_ns(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Date and Timestamp with Nanoseconds from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp_us(char*, std::size_t) noexcept; // Write current UTC ISO Date and Timestamp with Microseconds into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_date_timestamp_ns(char*, std::size_t) noexcept; // Write current UTC ISO Date and Timestamp with Nanoseconds into a buffer
+
+    [[nodiscard]] static std::size_t format_current_iso_date_time_offset(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Time with UTC offset from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_offset(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Date and Timestamp with UTC offset from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_time_offset(char*, std::size_t) noexcept; // Write current ISO Date and Time with UTC offset into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_date_timestamp_offset(char*, std::size_t) noexcept; // Write current ISO Date and Timestamp with UTC offset into a buffer
+
+    [[nodiscard]] static std::size_t format_current_iso_week_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Week Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_ordinal_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write ISO Ordinal Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_week_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Week Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_ordinal_date(char*, std::size_t, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Write UTC ISO Ordinal Date from a time_point into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_week_date(char*, std::size_t) noexcept; // Write current ISO Week Date into a buffer
+    [[nodiscard]] static std::size_t format_current_iso_ordinal_date(char*, std::size_t) noexcept; // Write current ISO Ordinal Date into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_week_date(char*, std::size_t) noexcept; // Write current UTC ISO Week Date into a buffer
+    [[nodiscard]] static std::size_t format_current_utc_iso_ordinal_date(char*, std::size_t) noexcept; // Write current UTC ISO Ordinal Date into a buffer
+
+    // Formatting selected by Format
+    [[nodiscard]] static constexpr std::size_t formatted_length(Format) noexcept; // Fixed length of the text for a Format
+    [[nodiscard]] static constexpr std::optional<Format> format_from_name(std::string_view) noexcept; // Look up a Format by its enumerator name, e.g. "utc_iso_date", or short name, e.g. "utc_date"
+    [[nodiscard]] static std::size_t format(Format, char*, std::size_t, const std::chrono::time_point<std::chrono::system_clock>&) noexcept; // Write one time_point into a buffer
+    static std::size_t format_batch(Format, const std::chrono::time_point<std::chrono::system_clock>*, std::size_t, char*, std::size_t) noexcept; // Write many time_points as consecutive fixed-width records
+    static std::size_t format_batch_parallel(Format, const std::chrono::time_point<std::chrono::system_clock>*, std::size_t, char*, std::size_t, unsigned = 0); // format_batch split across threads (0 for hardware_concurrency)
+    [[nodiscard]] static IsoStamp stamp(Format, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Get any Format from a time_point as an IsoStamp
+    [[nodiscard]] static IsoStamp stamp(Format) noexcept; // Get any Format for the current time as an IsoStamp
+
+    // Custom patterns: %Y %y %m %d %H %M %S %F %T %j %u %N (or %1N-%9N) %z %:z %%; anything else is copied literally
+    [[nodiscard]] static constexpr std::optional<FormatPlan> compile_format(std::string_view, bool = false) noexcept; // Compile a pattern for local (or UTC) time; nullopt if unsupported or too long
+    [[nodiscard]] static std::size_t format(const FormatPlan&, char*, std::size_t, const std::chrono::time_point<std::chrono::system_clock>&) noexcept; // Write one time_point through a plan
+    [[nodiscard]] static IsoStamp stamp(const FormatPlan&, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Get a time_point (or now) through a plan as an IsoStamp
+
+    // Capture now, render later: the producer pays for one clock read and an offset lookup, no text
+    [[nodiscard]] static CompactTime capture_compact(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Capture a time_point with the local UTC offset in effect
+    [[nodiscard]] static CompactTime capture_compact() noexcept; // Capture the current time with the local UTC offset in effect
+    static void encode_compact(const CompactTime&, unsigned char*) noexcept; // Serialise into compact_time_length bytes
+    [[nodiscard]] static CompactTime decode_compact(const unsigned char*) noexcept; // Deserialise from compact_time_length bytes
+    [[nodiscard]] static std::size_t format(Format, const CompactTime&, char*, std::size_t) noexcept; // Render a capture; local formats use the captured offset
+    [[nodiscard]] static IsoStamp stamp(Format, const CompactTime&) noexcept; // Render a capture as an IsoStamp
+    static std::size_t format_compact_batch(Format, const CompactTime*, std::size_t, char*, std::size_t) noexcept; // Render many captures as consecutive fixed-width records
+
+    // Deferred formatting: output is identical to the get_current_* function for the captured Format
+    [[nodiscard]] static DeferredStamp capture(Format, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Pair a time_point with a Format
+    [[nodiscard]] static DeferredStamp capture(Format) noexcept; // Pair the current time with a Format (one clock read)
+    [[nodiscard]] static std::size_t format(const DeferredStamp&, char*, std::size_t) noexcept; // Render a DeferredStamp into a buffer
+    [[nodiscard]] static IsoStamp stamp(const DeferredStamp&) noexcept; // Render a DeferredStamp as an IsoStamp
+    [[nodiscard]] static std::string to_string(const DeferredStamp&); // Render a DeferredStamp as a std::string
+
+    // Rewrite the first local (or +HH:MM) ISO timestamp of every line of a file as UTC 'Z' text, in parallel
+    [[nodiscard]] static LogRewriteResult rewrite_log_timestamps(const std::string&, const std::string&, const LogRewriteOptions&); // Input path, output path, options
+    [[nodiscard]] static LogRewriteResult rewrite_log_timestamps(const std::string&, const std::string&); // Scan every line, all cores, 8 MiB chunks
+
+    // Parse text produced by the functions above (fixed-position, no locale, no allocation)
+    [[nodiscard]] static std::optional<std::chrono::time_point<std::chrono::system_clock>> parse_iso(std::string_view) noexcept; // Parse local ISO text ('Z' suffix means UTC)
+    [[nodiscard]] static std::optional<std::chrono::time_point<std::chrono::system_clock>> parse_utc_iso(std::string_view) noexcept; // Parse UTC ISO text
+    static std::size_t parse_utc_iso_timestamps(const char*, std::size_t, std::size_t, std::optional<std::chrono::time_point<std::chrono::system_clock>>*) noexcept; // Parse fixed-width UTC timestamps (records, stride, count, results)
+
+    // ISO 8601 durations (PnDTnHnMnS) and intervals, through the same digit kernel; no allocation except get_*
+    [[nodiscard]] static std::size_t format_iso_duration(char*, std::size_t, const std::chrono::nanoseconds&) noexcept; // Write the shortest exact form, e.g. PT0.0015S or -P1DT2H
+    [[nodiscard]] static std::string get_iso_duration(const std::chrono::nanoseconds&); // Get a duration as ISO 8601 text
+    [[nodiscard]] static std::optional<std::chrono::nanoseconds> parse_iso_duration(std::string_view) noexcept; // Parse [+-]P[nW][nD][T[nH][nM][nS]], a fraction on the last part; no Y or month M
+    [[nodiscard]] static std::size_t format_iso_interval(Format, char*, std::size_t, const Interval&) noexcept; // Write start/end, both in a Format
+    [[nodiscard]] static std::string get_iso_interval(Format, const Interval&); // Get start/end as ISO 8601 text
+    [[nodiscard]] static std::optional<Interval> parse_iso_interval(std::string_view) noexcept; // Parse start/end, start/duration or duration/end
+
+    // Strict fixed-width ISO 8601 week dates and ordinal dates, as the format_current_* functions write them
+    [[nodiscard]] static std::optional<CivilDate> parse_iso_week_date(std::string_view) noexcept; // Parse YYYY-Www-D into a calendar date
+    [[nodiscard]] static std::optional<CivilDate> parse_iso_ordinal_date(std::string_view) noexcept; // Parse YYYY-DDD into a calendar date
+
+    // Order-preserving 64-bit keys packing year:14 month:4 day:5 hour:5 minute:6 second:6 microsecond:20; +HH:MM text is moved to UTC, 0 marks text with no key
+    [[nodiscard]] static std::optional<std::uint64_t> sortable_key(std::string_view) noexcept; // Key of any text the Formats produce
+    static std::size_t sortable_keys(const char*, std::size_t, std::size_t, std::size_t, std::uint64_t*) noexcept; // Keys of fixed-width records (records, stride, length, count, keys)
+
+    // Opt-in cached local UTC offsets, avoiding localtime_r and its tz lock on the hot path
+    static void enable_local_offset_cache(const std::chrono::seconds& = std::chrono::hours(1)); // Compute local time from a cached offset table
+    static void disable_local_offset_cache() noexcept; // Go back to localtime_r
+    static void refresh_local_offset_cache(); // Reload the zone, rebuild the offset table and drop the cached local date now
+
+    // Compile-time UTC formatting of known time_points, e.g. constexpr auto stamp = make_utc_iso<Format::utc_iso_date>(tp);
+    template <Format F, typename Duration>
+    [[nodiscard]] static constexpr auto make_utc_iso(const std::chrono::time_point<std::chrono::system_clock, Duration>&) noexcept -> std::array<char, formatted_length(F)>; // Format a UTC Format into a std::array (no null terminator)
+
+    // Clock source for the no-argument functions
+    static void set_clock_source(ClockSource); // Select the clock (calibrates the TSC when selected)
+    [[nodiscard]] static ClockSource get_clock_source() noexcept; // Currently effective clock
+    static void set_monotonic_mode(MonotonicMode) noexcept; // Read system time off a steady_clock anchor and never go backwards
+    [[nodiscard]] static MonotonicMode get_monotonic_mode() noexcept; // Current ordering guarantee
+
+    // IANA time zones read from tzdata ($TZDIR or /usr/share/zoneinfo) into a process-wide cache; lookups never lock or allocate
+    [[nodiscard]] static std::optional<TimeZone> load_zone(std::string_view); // Load a zone by IANA name, e.g. "Europe/Paris" (cached after the first call)
+    [[nodiscard]] static std::string_view zone_name(const TimeZone&) noexcept; // IANA name the zone was loaded as
+    [[nodiscard]] static std::chrono::seconds utc_offset(const TimeZone&, const std::chrono::time_point<std::chrono::system_clock>&) noexcept; // UTC offset in effect in a zone at a time_point
+    [[nodiscard]] static constexpr std::size_t zoned_length(Format) noexcept; // Fixed length of the text for a Format rendered in a zone
+    [[nodiscard]] static std::size_t format(Format, const TimeZone&, char*, std::size_t, const std::chrono::time_point<std::chrono::system_clock>&) noexcept; // Write one time_point in a zone with a +HH:MM suffix
+    [[nodiscard]] static IsoStamp stamp(Format, const TimeZone&, const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept; // Get any Format in a zone as an IsoStamp
+
+    // Background ticker thread publishing pre-rendered millisecond timestamps
+    static void start_ticker(const std::chrono::microseconds& = std::chrono::milliseconds(1), bool = false); // Start publishing every resolution (optionally serving the no-argument *_timestamp functions)
+    static void stop_ticker(); // Stop and join the ticker thread
+    [[nodiscard]] static IsoStamp get_ticker_iso_date_timestamp() noexcept; // Latest published ISO Date and Timestamp
+    [[nodiscard]] static IsoStamp get_ticker_utc_iso_date_timestamp() noexcept; // Latest published UTC ISO Date and Timestamp
+
+    // Instrumentation snapshot (see Counters); cheap enough to scrape for metrics export
+    [[nodiscard]] static Counters get_counters(); // Totals over all threads since start or the last reset_counters()
+    static void reset_counters(); // Start counting from zero
+
+    // Calendar arithmetic (constexpr, no libc)
+    [[nodiscard]] static constexpr CivilDate civil_from_days(std::int64_t) noexcept; // Convert days since 1970-01-01 to a calendar date
+    [[nodiscard]] static constexpr std::int64_t days_from_civil(std::int64_t, unsigned, unsigned) noexcept; // Convert a calendar date to days since 1970-01-01
+    [[nodiscard]] static constexpr WeekDate week_date_from_days(std::int64_t) noexcept; // Convert days since 1970-01-01 to an ISO 8601 week date
+    [[nodiscard]] static constexpr std::int64_t days_from_week_date(std::int64_t, unsigned, unsigned) noexcept; // Convert an ISO 8601 week date to days since 1970-01-01 (not validated)
+
     private:
     // Static Private functions
     static std::chrono::time_point<std::chrono::system_clock> get_input_time_point_or_current_system_time(const std::optional<std::chrono::time_point<std::chrono::system_clock>>&) noexcept;
-    static std::string get_formatted_milliseconds(const std::chrono::milliseconds&); // format
 
 };
 
+// ---------- Digit kernel ----------
+
+// Header-inline and constexpr so the same code serves both the library and make_utc_iso
+namespace isodatetime_detail {
+
+/**
+ * @brief Two-digit lookup table: the characters for n (0-99) are at [2n, 2n + 1].
+ */
+inline constexpr char digit_pairs[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Write a value in the range 0-99 as two digits.
+ */
+constexpr void write_2_digits(char* out, unsigned value) noexcept
+{
+    out[0] = digit_pairs[value * 2];
+    out[1] = digit_pairs[value * 2 + 1];
+}
+
+/**
+ * @brief Write a value in the range 0-999 as three digits.
+ */
+constexpr void write_3_digits(char* out, unsigned value) noexcept
+{
+    out[0] = static_cast<char>('0' + value / 100);
+    write_2_digits(out + 1, value % 100);
+}
+
+/**
+ * @brief Write a value in the range 0-9999 as four digits.
+ */
+constexpr void write_4_digits(char* out, unsigned value) noexcept
+{
+    write_2_digits(out, value / 100);
+    write_2_digits(out + 2, value % 100);
+}
+
+/**
+ * @brief Write a '.' followed by the leading 3, 6 or 9 digits of a nanosecond fraction.
+ * @param out Destination; must have room for fraction_digits + 1 characters.
+ * @param nanoseconds Nanoseconds into the second, 0-999999999.
+ * @param fraction_digits 3 (milliseconds), 6 (microseconds) or 9 (nanoseconds).
+ */
+constexpr void write_fraction(char* out, std::uint32_t nanoseconds, unsigned fraction_digits) noexcept
+{
+    out[0] = '.';
+    write_3_digits(out + 1, nanoseconds / 1000000);
+    if (fraction_digits >= 6)
+        write_3_digits(out + 4, nanoseconds / 1000 % 1000);
+    if (fraction_digits >= 9)
+        write_3_digits(out + 7, nanoseconds % 1000);
+}
+
+/**
+ * @brief Write the THH:MM:SS part of a second of the day.
+ * @param out Destination; must have room for 9 characters.
+ * @param second_of_day Seconds since midnight, 0-86399.
+ */
+constexpr void write_time_of_day(char* out, std::uint32_t second_of_day) noexcept
+{
+    out[0] = 'T';
+    write_2_digits(out + 1, second_of_day / 3600);
+    out[3] = ':';
+    write_2_digits(out + 4, second_of_day / 60 % 60);
+    out[6] = ':';
+    write_2_digits(out + 7, second_of_day % 60);
+}
+
+/**
+ * @brief Reached only for years outside 0000-9999; not constexpr, so such a year fails constant evaluation.
+ */
+inline void year_not_representable() noexcept {}
+
+/**
+ * @brief Write a year as four digits.
+ *
+ * A year outside 0000-9999 fails constant evaluation; at run time it is saturated to 0000 or
+ * 9999, so the digit table is never indexed out of range. The library's own writers reject
+ * such years before getting here.
+ *
+ * @param out Destination; must have room for 4 characters.
+ * @param year Calendar year, expected in 0000-9999.
+ */
+constexpr void write_year(char* out, std::int64_t year) noexcept
+{
+    if (year < 0 || year > 9999) {
+        year_not_representable();
+        year = year < 0 ? 0 : 9999;
+    }
+    write_4_digits(out, static_cast<unsigned>(year));
+}
+
+/**
+ * @brief Write YYYY-MM-DD.
+ * @param out Destination; must have room for 10 characters.
+ * @param date Calendar date; a year outside 0000-9999 is handled as by write_year.
+ */
+constexpr void write_civil_date(char* out, const ISODateTime::CivilDate& date) noexcept
+{
+    write_year(out, date.year);
+    out[4] = '-';
+    write_2_digits(out + 5, date.month);
+    out[7] = '-';
+    write_2_digits(out + 8, date.day);
+}
+
+/**
+ * @brief Write YYYY-Www-D.
+ * @param out Destination; must have room for 10 characters.
+ * @param date Week date; a year outside 0000-9999 is handled as by write_year.
+ */
+constexpr void write_week_date(char* out, const ISODateTime::WeekDate& date) noexcept
+{
+    write_year(out, date.year);
+    out[4] = '-';
+    out[5] = 'W';
+    write_2_digits(out + 6, date.week);
+    out[8] = '-';
+    out[9] = static_cast<char>('0' + date.weekday);
+}
+
+/**
+ * @brief Write YYYY-DDD.
+ * @param out Destination; must have room for 8 characters.
+ * @param year Calendar year; outside 0000-9999 it is handled as by write_year.
+ * @param day_of_year Day of the year, 1-366.
+ */
+constexpr void write_ordinal_date(char* out, std::int64_t year, unsigned day_of_year) noexcept
+{
+    write_year(out, year);
+    out[4] = '-';
+    write_3_digits(out + 5, day_of_year);
+}
+
+/**
+ * @brief A Format with its enumerator name and short name, for ISODateTime::format_from_name.
+ */
+struct named_format {
+    std::string_view name;
+    std::string_view short_name;
+    ISODateTime::Format format;
+};
+
+// At namespace scope so the lookup does not rebuild the table on every call
+inline constexpr named_format format_names[] = {
+    {"iso_date", "date", ISODateTime::Format::iso_date},
+    {"iso_date_time", "date_time", ISODateTime::Format::iso_date_time},
+    {"iso_date_timestamp", "timestamp", ISODateTime::Format::iso_date_timestamp},
+    {"iso_date_timestamp_us", "timestamp_us", ISODateTime::Format::iso_date_timestamp_us},
+    {"iso_date_timestamp_ns", "timestamp_ns", ISODateTime::Format::iso_date_timestamp_ns},
+    {"utc_iso_date", "utc_date", ISODateTime::Format::utc_iso_date},
+    {"utc_iso_date_time", "utc_date_time", ISODateTime::Format::utc_iso_date_time},
+    {"utc_iso_date_timestamp", "utc_timestamp", ISODateTime::Format::utc_iso_date_timestamp},
+    {"utc_iso_date_timestamp_us", "utc_timestamp_us", ISODateTime::Format::utc_iso_date_timestamp_us},
+    {"utc_iso_date_timestamp_ns", "utc_timestamp_ns", ISODateTime::Format::utc_iso_date_timestamp_ns},
+    {"iso_date_time_offset", "date_time_offset", ISODateTime::Format::iso_date_time_offset},
+    {"iso_date_timestamp_offset", "timestamp_offset", ISODateTime::Format::iso_date_timestamp_offset},
+    {"iso_date_timestamp_us_offset", "timestamp_us_offset", ISODateTime::Format::iso_date_timestamp_us_offset},
+    {"iso_date_timestamp_ns_offset", "timestamp_ns_offset", ISODateTime::Format::iso_date_timestamp_ns_offset},
+};
+
+} // namespace isodatetime_detail
+
+// ---------- Inline definitions ----------
+
+/**
+ * @brief Fixed length of the text written for a Format.
+ * @param format Output format.
+ * @return Length in bytes, matching the corresponding *_length constant.
+ */
+constexpr std::size_t ISODateTime::formatted_length(Format format) noexcept
+{
+    switch (format) {
+        case Format::iso_date: return iso_date_length;
+        case Format::iso_date_time: return iso_date_time_length;
+        case Format::iso_date_timestamp: return iso_date_timestamp_length;
+        case Format::iso_date_timestamp_us: return iso_date_timestamp_us_length;
+        case Format::iso_date_timestamp_ns: return iso_date_timestamp_ns_length;
+        case Format::utc_iso_date: return utc_iso_date_length;
+        case Format::utc_iso_date_time: return utc_iso_date_time_length;
+        case Format::utc_iso_date_timestamp: return utc_iso_date_timestamp_length;
+        case Format::utc_iso_date_timestamp_us: return utc_iso_date_timestamp_us_length;
+        case Format::utc_iso_date_timestamp_ns: return utc_iso_date_timestamp_ns_length;
+        case Format::iso_date_time_offset: return iso_date_time_offset_length;
+        case Format::iso_date_timestamp_offset: return iso_date_timestamp_offset_length;
+        case Format::iso_date_timestamp_us_offset: return iso_date_timestamp_us_offset_length;
+        case Format::iso_date_timestamp_ns_offset: return iso_date_timestamp_ns_offset_length;
+    }
+    return 0;
+}
+
+/**
+ * @brief Look up a Format by name, for format specs and configuration files.
+ *
+ * Accepts each enumerator's own name and a short name without the "iso_" part and, for
+ * timestamps, without "date_": "date", "date_time", "timestamp", "timestamp_us",
+ * "timestamp_ns", each optionally prefixed "utc_", and "date_time_offset",
+ * "timestamp_offset", "timestamp_us_offset", "timestamp_ns_offset".
+ *
+ * @param name Name to look up; case-sensitive.
+ * @return The Format, or std::nullopt if the name is unknown.
+ */
+constexpr std::optional<ISODateTime::Format> ISODateTime::format_from_name(std::string_view name) noexcept
+{
+    for (const auto& entry : isodatetime_detail::format_names) {
+        if (name == entry.name || name == entry.short_name)
+            return entry.format;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Fixed length of the text written for a Format rendered in a time zone.
+ *
+ * Zoned text has the shape of the local Format followed by a +HH:MM offset; dates carry no offset.
+ *
+ * @param format Output format; the local, UTC and offset variants of a shape give the same length.
+ * @return Length in bytes, matching the corresponding *_offset_length constant.
+ */
+constexpr std::size_t ISODateTime::zoned_length(Format format) noexcept
+{
+    switch (format) {
+        case Format::iso_date:
+        case Format::utc_iso_date: return iso_date_length;
+        case Format::iso_date_time:
+        case Format::utc_iso_date_time:
+        case Format::iso_date_time_offset: return iso_date_time_offset_length;
+        case Format::iso_date_timestamp:
+        case Format::utc_iso_date_timestamp:
+        case Format::iso_date_timestamp_offset: return iso_date_timestamp_offset_length;
+        case Format::iso_date_timestamp_us:
+        case Format::utc_iso_date_timestamp_us:
+        case Format::iso_date_timestamp_us_offset: return iso_date_timestamp_us_offset_length;
+        case Format::iso_date_timestamp_ns:
+        case Format::utc_iso_date_timestamp_ns:
+        case Format::iso_date_timestamp_ns_offset: return iso_date_timestamp_ns_offset_length;
+    }
+    return 0;
+}
+
+/**
+ * @brief Compile a strftime-like pattern into a FormatPlan.
+ *
+ * Every supported field has a fixed width, so the plan knows its output length up front and
+ * formatting is a copy of the literal text followed by one write per field. Consecutive date
+ * and time fields that line up with the YYYY-MM-DDTHH:MM:SS prefix (for example "%FT%T" or
+ * "%Y-%m-%d") merge into a single copy from the per-thread seconds cache. Because this is
+ * constexpr, a constant pattern can be compiled at compile time:
+ * constexpr auto plan = ISODateTime::compile_format("%Y%m%dT%H%M%S").value();
+ *
+ * @param pattern Literal text with % fields: %Y year (4 digits), %y year (2), %m month, %d day,
+ *                %H hour, %M minute, %S second, %F (%Y-%m-%d), %T (%H:%M:%S), %j day of the
+ *                year (3), %u ISO weekday (1), %N nanoseconds (9) or %1N-%9N leading fraction
+ *                digits, %z +HHMM, %:z +HH:MM, %% a literal '%'. The fraction has no separator,
+ *                so ".%3N" and ",%3N" both work.
+ * @param utc Whether fields are rendered in UTC (offsets are then +0000) instead of local time.
+ * @return The plan, or std::nullopt for an unknown field or output longer than format_plan_max_length.
+ */
+constexpr std::optional<ISODateTime::FormatPlan> ISODateTime::compile_format(std::string_view pattern, bool utc) noexcept
+{
+    constexpr std::string_view prefix_layout = "0000-00-00T00:00:00";
+    FormatPlan plan{};
+    plan.utc = utc;
+    std::size_t length = 0;
+    bool fits = true;
+    const auto add_field = [&](FormatPlan::Field field, std::size_t source, std::size_t width) {
+        if (length + width > format_plan_max_length) {
+            fits = false;
+            return;
+        }
+        FormatPlan::Step* last = plan.step_count != 0 ? &plan.steps[plan.step_count - 1] : nullptr;
+        if (field == FormatPlan::Field::prefix && last != nullptr && last->field == FormatPlan::Field::prefix
+            && last->out + last->width == length && last->source + last->width == source)
+            last->width = static_cast<std::uint8_t>(last->width + width);
+        else
+            plan.steps[plan.step_count++] = {field, static_cast<std::uint8_t>(length), static_cast<std::uint8_t>(source), static_cast<std::uint8_t>(width)};
+        length += width;
+    };
+    const auto add_literal = [&](char c) {
+        if (length == format_plan_max_length) {
+            fits = false;
+            return;
+        }
+        plan.text[length] = c;
+        // A separator that continues a prefix slice ('-', 'T', ':') is copied along with it
+        FormatPlan::Step* last = plan.step_count != 0 ? &plan.steps[plan.step_count - 1] : nullptr;
+        if (last != nullptr && last->field == FormatPlan::Field::prefix && last->out + last->width == length
+            && last->source + last->width < prefix_layout.size() && prefix_layout[last->source + last->width] == c)
+            ++last->width;
+        ++length;
+    };
+
+    for (std::size_t i = 0; i < pattern.size() && fits; ++i) {
+        if (pattern[i] != '%') {
+            add_literal(pattern[i]);
+            continue;
+        }
+        if (++i == pattern.size())
+            return std::nullopt;
+        switch (pattern[i]) {
+            case 'Y': add_field(FormatPlan::Field::prefix, 0, 4); break;
+            case 'y': add_field(FormatPlan::Field::prefix, 2, 2); break;
+            case 'm': add_field(FormatPlan::Field::prefix, 5, 2); break;
+            case 'd': add_field(FormatPlan::Field::prefix, 8, 2); break;
+            case 'H': add_field(FormatPlan::Field::prefix, 11, 2); break;
+            case 'M': add_field(FormatPlan::Field::prefix, 14, 2); break;
+            case 'S': add_field(FormatPlan::Field::prefix, 17, 2); break;
+            case 'F': add_field(FormatPlan::Field::prefix, 0, 10); break;
+            case 'T': add_field(FormatPlan::Field::prefix, 11, 8); break;
+            case 'j': add_field(FormatPlan::Field::day_of_year, 0, 3); break;
+            case 'u': add_field(FormatPlan::Field::weekday, 0, 1); break;
+            case 'N': add_field(FormatPlan::Field::fraction, 0, 9); break;
+            case 'z': add_field(FormatPlan::Field::offset, 0, 5); break;
+            case '%': add_literal('%'); break;
+            case ':':
+                if (i + 1 == pattern.size() || pattern[i + 1] != 'z')
+                    return std::nullopt;
+                add_field(FormatPlan::Field::offset_colon, 0, 6);
+                ++i;
+                break;
+            default:
+                if (pattern[i] < '1' || pattern[i] > '9' || i + 1 == pattern.size() || pattern[i + 1] != 'N')
+                    return std::nullopt;
+                add_field(FormatPlan::Field::fraction, 0, static_cast<std::size_t>(pattern[i] - '0'));
+                ++i;
+                break;
+        }
+    }
+    if (!fits)
+        return std::nullopt;
+    plan.length = static_cast<std::uint8_t>(length);
+    return plan;
+}
+
+/**
+ * @brief Convert a count of days since 1970-01-01 into a proleptic Gregorian calendar date.
+ *
+ * Pure integer arithmetic after Howard Hinnant's civil_from_days: the day count is shifted so
+ * that eras of 400 years start on 0000-03-01, which puts the leap day at the end of each year.
+ * Valid for the whole int64 day range that does not overflow the shift.
+ *
+ * @param days Days since the Unix epoch; negative values are before 1970.
+ * @return The calendar date.
+ */
+constexpr ISODateTime::CivilDate ISODateTime::civil_from_days(std::int64_t days) noexcept
+{
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto day_of_era = static_cast<std::uint64_t>(days - era * 146097); // [0, 146096]
+    const std::uint64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365; // [0, 399]
+    const std::uint64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100); // [0, 365]
+    const std::uint64_t month_index = (5 * day_of_year + 2) / 153; // [0, 11], March-based
+    const auto day = static_cast<unsigned>(day_of_year - (153 * month_index + 2) / 5 + 1);
+    const auto month = static_cast<unsigned>(month_index < 10 ? month_index + 3 : month_index - 9);
+    const std::int64_t year = static_cast<std::int64_t>(year_of_era) + era * 400 + (month <= 2 ? 1 : 0);
+    return {year, month, day};
+}
+
+/**
+ * @brief Convert a proleptic Gregorian calendar date into a count of days since 1970-01-01.
+ *
+ * Inverse of civil_from_days. The month and day are not validated.
+ *
+ * @param year Calendar year.
+ * @param month Month of the year, 1-12.
+ * @param day Day of the month, 1-31.
+ * @return Days since the Unix epoch; negative values are before 1970.
+ */
+constexpr std::int64_t ISODateTime::days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept
+{
+    year -= month <= 2 ? 1 : 0;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto year_of_era = static_cast<std::uint64_t>(year - era * 400); // [0, 399]
+    const std::uint64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    const std::uint64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year; // [0, 146096]
+    return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+}
+
+namespace isodatetime_detail {
+
+/**
+ * @brief Weekday of a day count: 1 (Monday) - 7 (Sunday). 1970-01-01 was a Thursday.
+ */
+constexpr unsigned weekday_from_days(std::int64_t days) noexcept
+{
+    return static_cast<unsigned>((days % 7 + 7 + 3) % 7) + 1;
+}
+
+} // namespace isodatetime_detail
+
+/**
+ * @brief Convert a count of days since 1970-01-01 into an ISO 8601 week date.
+ *
+ * Weeks start on Monday and week 1 is the week holding the year's first Thursday, so the
+ * week-numbering year is the calendar year of the Thursday of the same week.
+ *
+ * @param days Days since the Unix epoch; negative values are before 1970.
+ * @return The week date.
+ */
+constexpr ISODateTime::WeekDate ISODateTime::week_date_from_days(std::int64_t days) noexcept
+{
+    const unsigned weekday = isodatetime_detail::weekday_from_days(days);
+    const std::int64_t thursday = days + 4 - static_cast<std::int64_t>(weekday);
+    const std::int64_t year = civil_from_days(thursday).year;
+    const auto week = static_cast<unsigned>((thursday - days_from_civil(year, 1, 1)) / 7 + 1);
+    return {year, week, weekday};
+}
+
+/**
+ * @brief Convert an ISO 8601 week date into a count of days since 1970-01-01.
+ *
+ * Inverse of week_date_from_days. The week and weekday are not validated.
+ *
+ * @param year Week-numbering year.
+ * @param week Week of the year, 1-53.
+ * @param weekday Day of the week, 1 (Monday) - 7 (Sunday).
+ * @return Days since the Unix epoch.
+ */
+constexpr std::int64_t ISODateTime::days_from_week_date(std::int64_t year, unsigned week, unsigned weekday) noexcept
+{
+    // January 4th is always in week 1
+    const std::int64_t january_4 = days_from_civil(year, 1, 4);
+    const std::int64_t week_1_monday = january_4 - (isodatetime_detail::weekday_from_days(january_4) - 1);
+    return week_1_monday + (static_cast<std::int64_t>(week) - 1) * 7 + (static_cast<std::int64_t>(weekday) - 1);
+}
+
+/**
+ * @brief Format a time_point in one of the UTC Formats at compile time.
+ *
+ * Uses only constexpr calendar arithmetic and the header digit kernel, so with a constant
+ * time_point the text is produced by the compiler and costs nothing at startup. Output is
+ * identical to the corresponding get_current_utc_* function. A year outside 0000-9999 makes
+ * the call non-constant (a compile error in constexpr contexts); at run time the year is
+ * saturated to 0000 or 9999 while the rest of the date and time is written as usual.
+ *
+ * @tparam F A UTC Format (utc_iso_date ... utc_iso_date_timestamp_ns).
+ * @param time_point Time to format.
+ * @return The text, without a null terminator.
+ */
+template <ISODateTime::Format F, typename Duration>
+constexpr auto ISODateTime::make_utc_iso(const std::chrono::time_point<std::chrono::system_clock, Duration>& time_point) noexcept -> std::array<char, formatted_length(F)>
+{
+    static_assert(F >= Format::utc_iso_date && F <= Format::utc_iso_date_timestamp_ns, "make_utc_iso only produces UTC formats");
+    constexpr std::size_t length = formatted_length(F);
+    // Lengths are 10 (date), 20 (date-time) and 21 + fraction digits (timestamps)
+    constexpr unsigned fraction_digits = length > 20 ? static_cast<unsigned>(length - 21) : 0;
+
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(time_point);
+    const auto nanoseconds = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - seconds).count());
+    const std::int64_t epoch_seconds = seconds.time_since_epoch().count();
+    const std::int64_t days = (epoch_seconds >= 0 ? epoch_seconds : epoch_seconds - 86399) / 86400;
+
+    std::array<char, length> text{};
+    isodatetime_detail::write_civil_date(text.data(), civil_from_days(days));
+    if constexpr (length > 10) {
+        isodatetime_detail::write_time_of_day(text.data() + 10, static_cast<std::uint32_t>(epoch_seconds - days * 86400));
+        if constexpr (fraction_digits != 0)
+            isodatetime_detail::write_fraction(text.data() + 19, nanoseconds, fraction_digits);
+        text[length - 1] = 'Z';
+    }
+    return text;
+}
+
+#if defined(ISODATETIME_HEADER_ONLY)
+#include "ISODateTimeImpl.h"
+#endif
+
 #endif //ISODATETIME_LIBRARY_H
\ No newline at end of file
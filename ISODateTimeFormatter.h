@@ -0,0 +1,169 @@
+#ifndef ISODATETIME_FORMATTER_H
+#define ISODATETIME_FORMATTER_H
+
+// std::formatter (when <format> is available) and fmt::formatter (when fmtlib is on the include
+// path; define ISODATETIME_NO_FMT to skip it) for ISODateTime::IsoTime and ISODateTime::DeferredStamp.
+//
+//     fmt::format("{} {:utc_timestamp}", ISODateTime::IsoTime{tp}, ISODateTime::IsoTime{tp});
+//
+// The spec is a Format name accepted by ISODateTime::format_from_name; an empty spec means
+// iso_date_timestamp for IsoTime and the captured Format for DeferredStamp. The text is rendered
+// by ISODateTime::format into a stack buffer and copied straight to the output iterator, with no
+// intermediate std::string.
+
+#include "ISODateTime.h"
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+#if !defined(ISODATETIME_NO_FMT) && __has_include(<fmt/format.h>)
+#include <fmt/format.h>
+#define ISODATETIME_FORMATTER_FMT
+#endif
+
+namespace isodatetime_detail {
+
+/**
+ * @brief Spec parsing and output shared by the std::format and fmt formatters.
+ */
+struct iso_formatter_core {
+    std::optional<ISODateTime::Format> format; // set by a non-empty spec
+
+    /**
+     * @brief Parse a spec up to the closing '}'.
+     * @param it Start of the spec; left on the closing '}' (or end).
+     * @param end End of the format string.
+     * @return false if the spec is not a Format name.
+     */
+    template <typename Iterator>
+    constexpr bool parse(Iterator& it, Iterator end)
+    {
+        const Iterator first = it;
+        while (it != end && *it != '}')
+            ++it;
+        if (it == first)
+            return true;
+        format = ISODateTime::format_from_name(std::string_view(&*first, static_cast<std::size_t>(it - first)));
+        return format.has_value();
+    }
+
+    /**
+     * @brief Render a time_point in a Format and copy it to an output iterator.
+     */
+    template <typename Out>
+    Out write(Out out, ISODateTime::Format selected, const std::chrono::time_point<std::chrono::system_clock>& time_point) const
+    {
+        char text[sizeof(ISODateTime::IsoStamp::data)];
+        const std::size_t length = ISODateTime::format(selected, text, sizeof(text), time_point);
+        return std::copy_n(text, length, out);
+    }
+};
+
+} // namespace isodatetime_detail
+
+#if defined(__cpp_lib_format)
+namespace std {
+
+template <>
+struct formatter<ISODateTime::IsoTime, char> {
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        auto it = ctx.begin();
+        if (!core_.parse(it, ctx.end()))
+            throw format_error("ISODateTime: unknown Format name in format spec");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const ISODateTime::IsoTime& time, FormatContext& ctx) const
+    {
+        return core_.write(ctx.out(), core_.format.value_or(ISODateTime::Format::iso_date_timestamp), time.time_point);
+    }
+
+private:
+    isodatetime_detail::iso_formatter_core core_;
+};
+
+template <>
+struct formatter<ISODateTime::DeferredStamp, char> {
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        auto it = ctx.begin();
+        if (!core_.parse(it, ctx.end()))
+            throw format_error("ISODateTime: unknown Format name in format spec");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const ISODateTime::DeferredStamp& deferred, FormatContext& ctx) const
+    {
+        return core_.write(ctx.out(), core_.format.value_or(deferred.format), deferred.time_point);
+    }
+
+private:
+    isodatetime_detail::iso_formatter_core core_;
+};
+
+} // namespace std
+#endif
+
+#if defined(ISODATETIME_FORMATTER_FMT)
+namespace fmt {
+
+template <>
+struct formatter<ISODateTime::IsoTime> {
+    constexpr auto parse(format_parse_context& ctx) -> decltype(ctx.begin())
+    {
+        auto it = ctx.begin();
+        if (!core_.parse(it, ctx.end()))
+            throw format_error("ISODateTime: unknown Format name in format spec");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const ISODateTime::IsoTime& time, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        char text[sizeof(ISODateTime::IsoStamp::data)];
+        const std::size_t length = ISODateTime::format(core_.format.value_or(ISODateTime::Format::iso_date_timestamp), text, sizeof(text), time.time_point);
+        return text_.format(string_view(text, length), ctx);
+    }
+
+private:
+    isodatetime_detail::iso_formatter_core core_;
+    formatter<string_view> text_; // unspecified specs: a plain bulk append to the output buffer
+};
+
+template <>
+struct formatter<ISODateTime::DeferredStamp> {
+    constexpr auto parse(format_parse_context& ctx) -> decltype(ctx.begin())
+    {
+        auto it = ctx.begin();
+        if (!core_.parse(it, ctx.end()))
+            throw format_error("ISODateTime: unknown Format name in format spec");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const ISODateTime::DeferredStamp& deferred, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        char text[sizeof(ISODateTime::IsoStamp::data)];
+        const std::size_t length = ISODateTime::format(core_.format.value_or(deferred.format), text, sizeof(text), deferred.time_point);
+        return text_.format(string_view(text, length), ctx);
+    }
+
+private:
+    isodatetime_detail::iso_formatter_core core_;
+    formatter<string_view> text_; // unspecified specs: a plain bulk append to the output buffer
+};
+
+} // namespace fmt
+#endif
+
+#endif //ISODATETIME_FORMATTER_H
@@ -0,0 +1,4608 @@
+//
+// Created by Bijumon Chettipparambil Pavanajan on 09/08/2025.
+//
+// Implementation of ISODateTime. Compiled once by ISODateTime.cpp, or included by ISODateTime.h
+// when ISODATETIME_HEADER_ONLY is defined, in which case every definition is inline.
+//
+
+#ifndef ISODATETIME_IMPL_H
+#define ISODATETIME_IMPL_H
+
+#include "ISODateTime.h"
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ISODATETIME_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ISODATETIME_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace isodatetime_detail {
+
+/**
+ * @brief Convert a time_t value into a std::tm in local time, in a thread-safe manner.
+ *
+ * This function wraps platform-specific thread-safe variants:
+ * - Windows: localtime_s
+ * - POSIX (Linux, macOS, etc.): localtime_r
+ *
+ * @param t The time value to convert.
+ * @return A std::tm structure containing the local time representation.
+ */
+inline std::tm to_local_tm(std::time_t t) {
+    std::tm tm{};
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm); // POSIX: time_t* first, tm* second
+#endif
+    return tm;
+}
+
+/**
+ * @brief Convert a time_t value into a std::tm in UTC time using pure integer arithmetic.
+ *
+ * Unlike gmtime_r / gmtime_s this takes no locks and makes no library calls, so it is
+ * async-signal-safe. tm_isdst is always 0.
+ *
+ * @param t The time value to convert.
+ * @return A std::tm structure containing the UTC time representation.
+ */
+inline std::tm to_utc_tm(std::time_t t) noexcept {
+    const auto seconds = static_cast<std::int64_t>(t);
+    const std::int64_t days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    const auto second_of_day = static_cast<int>(seconds - days * 86400);
+    const auto date = ISODateTime::civil_from_days(days);
+
+    std::tm tm{};
+    tm.tm_year = static_cast<int>(date.year - 1900);
+    tm.tm_mon = static_cast<int>(date.month) - 1;
+    tm.tm_mday = static_cast<int>(date.day);
+    tm.tm_hour = second_of_day / 3600;
+    tm.tm_min = second_of_day / 60 % 60;
+    tm.tm_sec = second_of_day % 60;
+    tm.tm_wday = static_cast<int>((days % 7 + 11) % 7); // 1970-01-01 was a Thursday
+    tm.tm_yday = static_cast<int>(days - ISODateTime::days_from_civil(date.year, 1, 1));
+    return tm;
+}
+
+// ---------- Seqlock ----------
+
+/**
+ * @brief A single-writer, many-reader cell for a small trivially copyable value.
+ *
+ * Readers never block: they copy the value word by word and retry only if a writer was
+ * publishing at the same time. The payload is held in relaxed atomics so concurrent reads
+ * and writes are well-defined. Writers must be serialised by the caller.
+ */
+template <typename T>
+class seqlock_cell {
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock_cell requires a trivially copyable type");
+    static constexpr std::size_t word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+public:
+    /**
+     * @brief Copy out the most recently published value (zero-initialised words before the first store).
+     * @param version Optionally receives the version of the value returned, for comparison with version().
+     */
+    T load(std::uint32_t* version = nullptr) const noexcept
+    {
+        std::uint64_t words[word_count];
+        for (;;) {
+            const auto before = sequence_.load(std::memory_order_acquire);
+            if ((before & 1U) == 0) {
+                for (std::size_t i = 0; i < word_count; ++i)
+                    words[i] = words_[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence_.load(std::memory_order_relaxed) == before) {
+                    if (version != nullptr)
+                        *version = before;
+                    break;
+                }
+            }
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Version of the current value; changes on every store (0 before the first store).
+     */
+    std::uint32_t version() const noexcept
+    {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish a new value.
+     */
+    void store(const T& value) noexcept
+    {
+        std::uint64_t words[word_count]{};
+        std::memcpy(words, &value, sizeof(T));
+        const auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < word_count; ++i)
+            words_[i].store(words[i], std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    std::atomic<std::uint32_t> sequence_{0};
+    std::atomic<std::uint64_t> words_[word_count]{};
+};
+
+// ---------- Instrumentation ----------
+
+/**
+ * @brief Counter slots; the first ISODateTime::format_count are calls by Format, in Format order.
+ */
+enum class counter : std::size_t {
+    week_date_calls = ISODateTime::format_count,
+    ordinal_date_calls,
+    batch_records,
+    plan_calls,
+    zoned_calls,
+    compact_captures,
+    parse_calls,
+    ticker_reads,
+    clock_reads,
+    monotonic_clamps,
+    second_cache_hits,
+    second_cache_misses,
+    date_cache_hits,
+    date_cache_misses,
+    offset_table_hits,
+    offset_table_misses,
+    zone_index_hits,
+    zone_index_misses,
+    tm_conversion_ns,
+    rendering_ns,
+    count_
+};
+inline constexpr std::size_t counter_count = static_cast<std::size_t>(counter::count_);
+
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+/**
+ * @brief One thread's counters, linked into a registry so get_counters() can sum every thread.
+ *
+ * Only the owning thread writes, with a relaxed load and store rather than a locked add, so
+ * counting costs about as much as a plain increment; readers see each value untorn.
+ */
+struct counter_block {
+    std::atomic<std::uint64_t> values[counter_count]{};
+    counter_block* previous{nullptr};
+    counter_block* next{nullptr};
+};
+
+inline std::mutex counter_registry_writer; // guards the list, retired_counters and counter_baseline
+inline counter_block* counter_registry{nullptr};
+inline std::uint64_t retired_counters[counter_count]{}; // totals of threads that have exited
+inline std::uint64_t counter_baseline[counter_count]{}; // totals at the last reset_counters()
+
+/**
+ * @brief Registers this thread's counter_block on first use and folds it into the retired totals at thread exit.
+ */
+class counter_owner {
+public:
+    counter_owner()
+    {
+        const std::lock_guard<std::mutex> lock(counter_registry_writer);
+        block.next = counter_registry;
+        if (counter_registry != nullptr)
+            counter_registry->previous = &block;
+        counter_registry = &block;
+    }
+
+    ~counter_owner()
+    {
+        const std::lock_guard<std::mutex> lock(counter_registry_writer);
+        for (std::size_t i = 0; i < counter_count; ++i)
+            retired_counters[i] += block.values[i].load(std::memory_order_relaxed);
+        (block.previous != nullptr ? block.previous->next : counter_registry) = block.next;
+        if (block.next != nullptr)
+            block.next->previous = block.previous;
+    }
+
+    counter_block block;
+};
+
+/**
+ * @brief Sum of every thread's counters, live and retired. Caller holds counter_registry_writer.
+ */
+inline void sum_counters(std::uint64_t (&totals)[counter_count]) noexcept
+{
+    for (std::size_t i = 0; i < counter_count; ++i)
+        totals[i] = retired_counters[i];
+    for (const counter_block* block = counter_registry; block != nullptr; block = block->next) {
+        for (std::size_t i = 0; i < counter_count; ++i)
+            totals[i] += block->values[i].load(std::memory_order_relaxed);
+    }
+}
+
+inline std::uint64_t steady_nanoseconds_now() noexcept
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+/**
+ * @brief Add to one of this thread's counters; compiles to nothing without ISODATETIME_ENABLE_INSTRUMENTATION.
+ */
+inline void count(counter slot, std::uint64_t amount = 1) noexcept
+{
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+    thread_local counter_owner owner;
+    auto& value = owner.block.values[static_cast<std::size_t>(slot)];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+#else
+    static_cast<void>(slot);
+    static_cast<void>(amount);
+#endif
+}
+
+/**
+ * @brief Count one call that produces a Format.
+ */
+inline void count_format(ISODateTime::Format format) noexcept
+{
+    count(static_cast<counter>(static_cast<std::size_t>(format)));
+}
+
+/**
+ * @brief Accumulates elapsed steady_clock time into counters; an empty no-op without ISODATETIME_ENABLE_INSTRUMENTATION.
+ */
+class phase_timer {
+public:
+    /**
+     * @brief Add the time since construction (or the previous lap) to a counter.
+     */
+    void lap(counter slot) noexcept
+    {
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+        const auto now = steady_nanoseconds_now();
+        count(slot, now - started_);
+        started_ = now;
+#else
+        static_cast<void>(slot);
+#endif
+    }
+
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+private:
+    std::uint64_t started_ = steady_nanoseconds_now();
+#endif
+};
+
+// ---------- Local offset cache ----------
+
+/**
+ * @brief Maximum number of UTC offset changes held in one local offset table.
+ */
+inline constexpr std::size_t max_offset_transitions = 16;
+
+/**
+ * @brief Snapshot of the local zone's UTC offsets over a window of UTC seconds.
+ *
+ * Entry i applies from starts[i] up to starts[i + 1] (or window_end for the last entry).
+ */
+struct local_offset_table {
+    std::int64_t window_begin;
+    std::int64_t window_end;
+    std::int64_t expires; // steady_clock nanoseconds after which the table should be rebuilt
+    std::int64_t expires_utc; // the same moment as a UTC second, checked first to avoid a clock read
+    std::uint32_t count; // 0 if the table has never been built
+    std::int64_t starts[max_offset_transitions];
+    std::int32_t offsets[max_offset_transitions];
+    std::int8_t is_dst[max_offset_transitions];
+};
+
+inline seqlock_cell<local_offset_table> local_offsets;
+inline std::mutex local_offsets_writer;
+inline std::atomic<bool> local_offsets_enabled{false};
+inline std::atomic<std::int64_t> local_offsets_refresh_interval{0}; // steady_clock nanoseconds
+
+/**
+ * @brief Ask the C library for the local UTC offset in effect at a given UTC second.
+ * @param t UTC second to probe.
+ * @param is_dst Receives the tm_isdst flag at that second.
+ * @return Offset in seconds east of UTC.
+ */
+inline std::int32_t probe_local_offset(std::int64_t t, int& is_dst)
+{
+    const auto tm = to_local_tm(static_cast<std::time_t>(t));
+    is_dst = tm.tm_isdst;
+    const std::int64_t local_seconds = ISODateTime::days_from_civil(tm.tm_year + 1900LL, static_cast<unsigned>(tm.tm_mon + 1), static_cast<unsigned>(tm.tm_mday)) * 86400
+                                       + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    return static_cast<std::int32_t>(local_seconds - t);
+}
+
+/**
+ * @brief Rebuild and publish the local offset table around the current time. Caller holds local_offsets_writer.
+ *
+ * The window runs from one day in the past to 400 days ahead. It is sampled every six hours
+ * and each change of offset is located to the exact second by bisection, so a rebuild costs
+ * roughly two thousand localtime calls, paid once per refresh interval instead of once per format.
+ */
+inline void rebuild_local_offset_table()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    _tzset();
+#else
+    tzset();
+#endif
+    constexpr std::int64_t step = 6 * 3600;
+    const std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    local_offset_table table{};
+    table.window_begin = now - 86400;
+    table.window_end = now + 400 * 86400;
+    int is_dst = 0;
+    table.starts[0] = table.window_begin;
+    table.offsets[0] = probe_local_offset(table.window_begin, is_dst);
+    table.is_dst[0] = static_cast<std::int8_t>(is_dst);
+    table.count = 1;
+
+    for (std::int64_t low = table.window_begin; low < table.window_end; low += step) {
+        const std::int64_t high = low + step < table.window_end ? low + step : table.window_end;
+        if (probe_local_offset(high, is_dst) == table.offsets[table.count - 1])
+            continue;
+        if (table.count == max_offset_transitions) {
+            table.window_end = high; // keep what fits; later seconds fall back to localtime
+            break;
+        }
+        // Invariant: the offset at lo is the current one, the offset at hi is not
+        std::int64_t lo = low;
+        std::int64_t hi = high;
+        while (hi - lo > 1) {
+            const std::int64_t mid = lo + (hi - lo) / 2;
+            if (probe_local_offset(mid, is_dst) == table.offsets[table.count - 1])
+                lo = mid;
+            else
+                hi = mid;
+        }
+        table.starts[table.count] = hi;
+        table.offsets[table.count] = probe_local_offset(hi, is_dst);
+        table.is_dst[table.count] = static_cast<std::int8_t>(is_dst);
+        ++table.count;
+    }
+
+    const auto refresh_interval = local_offsets_refresh_interval.load(std::memory_order_relaxed);
+    table.expires = std::chrono::steady_clock::now().time_since_epoch().count() + refresh_interval;
+    table.expires_utc = now + std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::duration(refresh_interval)).count();
+    local_offsets.store(table);
+}
+
+/**
+ * @brief Look up the cached local UTC offset for a UTC second, without locking.
+ *
+ * An expired table is rebuilt by whichever thread first manages to take the writer lock;
+ * everyone else keeps using the previous table in the meantime. Expiry is noticed on the first
+ * lookup of a second at or after the expiry time, so formatting only historical times never
+ * triggers a rebuild.
+ *
+ * @param t UTC second to look up.
+ * @param is_dst Receives the tm_isdst flag at that second.
+ * @return Offset in seconds east of UTC, or std::nullopt if the cache is disabled or does not cover t.
+ */
+inline std::optional<std::int32_t> lookup_local_offset(std::int64_t t, int& is_dst)
+{
+    if (!local_offsets_enabled.load(std::memory_order_relaxed))
+        return std::nullopt;
+
+    // Each thread keeps its own copy of the table and only re-copies it when a new one is published
+    thread_local local_offset_table table{};
+    thread_local std::uint32_t table_version = 0;
+    if (local_offsets.version() != table_version)
+        table = local_offsets.load(&table_version);
+    // Seconds being formatted are normally close to now, so only those past the UTC expiry pay for a clock read
+    if (table.count == 0 || (t >= table.expires_utc && std::chrono::steady_clock::now().time_since_epoch().count() >= table.expires)) {
+        std::unique_lock<std::mutex> lock(local_offsets_writer, std::try_to_lock);
+        if (lock.owns_lock()) {
+            rebuild_local_offset_table();
+            table = local_offsets.load(&table_version);
+        }
+        if (table.count == 0) {
+            count(counter::offset_table_misses);
+            return std::nullopt;
+        }
+    }
+    if (t < table.window_begin || t >= table.window_end) {
+        count(counter::offset_table_misses);
+        return std::nullopt;
+    }
+    count(counter::offset_table_hits);
+
+    std::uint32_t low = 0;
+    std::uint32_t high = table.count;
+    while (high - low > 1) {
+        const std::uint32_t mid = (low + high) / 2;
+        if (table.starts[mid] <= t)
+            low = mid;
+        else
+            high = mid;
+    }
+    is_dst = table.is_dst[low];
+    return table.offsets[low];
+}
+
+/**
+ * @brief Convert a time_t value into a std::tm in local time, preferring the local offset cache.
+ *
+ * When the cache is enabled and covers t, local time is computed as UTC plus the cached
+ * offset with no call into the C library; otherwise this falls back to to_local_tm.
+ *
+ * @param t The time value to convert.
+ * @return A std::tm structure containing the local time representation.
+ */
+inline std::tm resolve_local_tm(std::time_t t)
+{
+    int is_dst = 0;
+    if (const auto offset = lookup_local_offset(t, is_dst)) {
+        auto tm = to_utc_tm(static_cast<std::time_t>(static_cast<std::int64_t>(t) + *offset));
+        tm.tm_isdst = is_dst;
+        return tm;
+    }
+    return to_local_tm(t);
+}
+
+// ---------- Clock sources ----------
+
+inline std::atomic<ISODateTime::ClockSource> clock_source{ISODateTime::ClockSource::system};
+
+/**
+ * @brief Read CLOCK_REALTIME_COARSE: the time of the last kernel tick, with no hardware clock access.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> read_coarse_clock() noexcept
+{
+#if defined(__linux__)
+    timespec ts{};
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+#else
+    return std::chrono::system_clock::now();
+#endif
+}
+
+/**
+ * @brief A TSC reading paired with the system_clock time it corresponds to.
+ */
+struct tsc_anchor {
+    std::uint64_t tsc;
+    std::int64_t system_nanoseconds;
+    std::uint64_t nanoseconds_per_tick; // 32.32 fixed point
+    std::uint64_t resync_ticks; // re-anchor once this many ticks have passed (about one second)
+};
+
+inline seqlock_cell<tsc_anchor> tsc_anchors;
+inline std::mutex tsc_anchors_writer;
+
+#if defined(ISODATETIME_X86)
+/**
+ * @brief Whether the CPU has an invariant TSC (constant rate across P-states and C-states).
+ */
+inline bool cpu_has_invariant_tsc() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if (static_cast<unsigned>(registers[0]) < 0x80000007U)
+        return false;
+    __cpuid(registers, 0x80000007);
+    return (registers[3] & (1 << 8)) != 0;
+#else
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+    return (edx & (1U << 8)) != 0;
+#endif
+}
+#endif
+
+/**
+ * @brief Current system_clock time in nanoseconds since the epoch.
+ */
+inline std::int64_t system_nanoseconds_now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Pair the current TSC with system_clock and publish it. Caller holds tsc_anchors_writer.
+ *
+ * The tick rate is measured over the interval since the previous anchor, or over a 10 ms
+ * calibration spin when there is none, so it becomes more precise the longer the clock runs.
+ *
+ * @return false if no usable TSC is available.
+ */
+inline bool resync_tsc_anchor()
+{
+#if defined(ISODATETIME_X86)
+    tsc_anchor previous = tsc_anchors.load();
+    if (previous.nanoseconds_per_tick == 0) {
+        if (!cpu_has_invariant_tsc())
+            return false;
+        previous.tsc = __rdtsc();
+        previous.system_nanoseconds = system_nanoseconds_now();
+        while (system_nanoseconds_now() - previous.system_nanoseconds < 10000000)
+            std::this_thread::yield();
+    }
+
+    tsc_anchor anchor{};
+    anchor.tsc = __rdtsc();
+    anchor.system_nanoseconds = system_nanoseconds_now();
+    const std::uint64_t ticks = anchor.tsc - previous.tsc;
+    const std::int64_t nanoseconds = anchor.system_nanoseconds - previous.system_nanoseconds;
+    if (ticks == 0 || nanoseconds <= 0)
+        return false;
+    anchor.nanoseconds_per_tick = static_cast<std::uint64_t>(static_cast<double>(nanoseconds) / static_cast<double>(ticks) * 4294967296.0);
+    anchor.resync_ticks = static_cast<std::uint64_t>(1e9 / static_cast<double>(nanoseconds) * static_cast<double>(ticks));
+    if (anchor.nanoseconds_per_tick == 0)
+        return false;
+    tsc_anchors.store(anchor);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Read the time from the TSC, converted with the current anchor.
+ *
+ * An anchor older than its resync interval is refreshed by the first thread to take the writer
+ * lock; other threads read system_clock meanwhile, so a stale rate is never extrapolated.
+ * A resync can step the result by the accumulated drift, typically well under a microsecond.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> read_tsc_clock() noexcept
+{
+#if defined(ISODATETIME_X86)
+    thread_local tsc_anchor anchor{};
+    thread_local std::uint32_t anchor_version = 0;
+    if (tsc_anchors.version() != anchor_version)
+        anchor = tsc_anchors.load(&anchor_version);
+
+    const std::uint64_t ticks = __rdtsc() - anchor.tsc;
+    if (anchor.nanoseconds_per_tick == 0 || ticks > anchor.resync_ticks) {
+        std::unique_lock<std::mutex> lock(tsc_anchors_writer, std::try_to_lock);
+        if (!lock.owns_lock() || !resync_tsc_anchor())
+            return std::chrono::system_clock::now();
+        anchor = tsc_anchors.load(&anchor_version);
+        return std::chrono::time_point<std::chrono::system_clock>(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(anchor.system_nanoseconds)));
+    }
+    const auto elapsed = static_cast<std::int64_t>((ticks * anchor.nanoseconds_per_tick) >> 32);
+    return std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(anchor.system_nanoseconds + elapsed)));
+#else
+    return std::chrono::system_clock::now();
+#endif
+}
+
+// ---------- Monotonic mode ----------
+
+inline std::atomic<ISODateTime::MonotonicMode> monotonic_mode{ISODateTime::MonotonicMode::off};
+
+/**
+ * @brief A steady_clock reading paired with the system_clock time it corresponds to.
+ */
+struct steady_anchor {
+    std::int64_t steady_nanoseconds;
+    std::int64_t system_nanoseconds; // 0 until the first anchor is taken
+};
+
+inline seqlock_cell<steady_anchor> steady_anchors;
+inline std::mutex steady_anchors_writer;
+inline constexpr std::int64_t steady_resync_nanoseconds = 1000000000; // re-anchor to system_clock about once a second
+
+/**
+ * @brief Highest time handed out in MonotonicMode::global, in system_clock ticks; on its own cache line.
+ */
+struct alignas(64) monotonic_high_water {
+    std::atomic<std::chrono::system_clock::rep> ticks{std::numeric_limits<std::chrono::system_clock::rep>::min()};
+};
+
+inline monotonic_high_water global_high_water;
+
+/**
+ * @brief Current steady_clock time in nanoseconds.
+ */
+inline std::int64_t steady_clock_nanoseconds_now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Read system time as steady_clock elapsed since the last system_clock anchor.
+ *
+ * Between anchors the result advances at the steady rate whatever system_clock does, so a step
+ * back under NTP or a leap second inside the interval is not seen. An anchor older than
+ * steady_resync_nanoseconds is refreshed by the first thread to take the writer lock (other
+ * threads read system_clock meanwhile); a step that happened since then shows up at that point,
+ * and the high-water mark absorbs it if it is backwards.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> read_steady_clock() noexcept
+{
+    thread_local steady_anchor anchor{};
+    thread_local std::uint32_t anchor_version = 0;
+    if (steady_anchors.version() != anchor_version)
+        anchor = steady_anchors.load(&anchor_version);
+
+    const std::int64_t elapsed = steady_clock_nanoseconds_now() - anchor.steady_nanoseconds;
+    if (anchor.system_nanoseconds == 0 || elapsed > steady_resync_nanoseconds) {
+        std::unique_lock<std::mutex> lock(steady_anchors_writer, std::try_to_lock);
+        if (!lock.owns_lock())
+            return std::chrono::system_clock::now();
+        steady_anchors.store({steady_clock_nanoseconds_now(), system_nanoseconds_now()});
+        anchor = steady_anchors.load(&anchor_version);
+        return std::chrono::time_point<std::chrono::system_clock>(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(anchor.system_nanoseconds)));
+    }
+    return std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(anchor.system_nanoseconds + elapsed)));
+}
+
+/**
+ * @brief Raise a reading to one tick past the last time handed out on this thread or in the process.
+ * @param now Clock reading.
+ * @param mode per_thread or global.
+ * @return now, or the high-water mark plus one tick if now is not later than it.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> advance_high_water(std::chrono::time_point<std::chrono::system_clock> now, ISODateTime::MonotonicMode mode) noexcept
+{
+    using rep = std::chrono::system_clock::rep;
+    const rep ticks = now.time_since_epoch().count();
+    rep next = 0;
+    if (mode == ISODateTime::MonotonicMode::per_thread) {
+        thread_local rep last = std::numeric_limits<rep>::min();
+        next = ticks > last ? ticks : last + 1;
+        last = next;
+    } else {
+        // Relaxed is enough: every update is an RMW on one atomic, so they are totally ordered
+        rep previous = global_high_water.ticks.load(std::memory_order_relaxed);
+        do {
+            next = ticks > previous ? ticks : previous + 1;
+        } while (!global_high_water.ticks.compare_exchange_weak(previous, next, std::memory_order_relaxed));
+    }
+    if (next != ticks)
+        count(counter::monotonic_clamps);
+    return std::chrono::time_point<std::chrono::system_clock>(std::chrono::system_clock::duration(next));
+}
+
+/**
+ * @brief Read the selected clock source as is, without counting a clock read or applying MonotonicMode.
+ *
+ * For deciding which day is current, where a high-water update or a counted read would be a
+ * side effect of formatting an explicit time_point.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> peek_clock() noexcept
+{
+    switch (clock_source.load(std::memory_order_relaxed)) {
+        case ISODateTime::ClockSource::realtime_coarse: return read_coarse_clock();
+        case ISODateTime::ClockSource::tsc: return read_tsc_clock();
+        case ISODateTime::ClockSource::system: break;
+    }
+    return std::chrono::system_clock::now();
+}
+
+/**
+ * @brief Read the currently selected clock source, made monotonic when a MonotonicMode is set.
+ */
+inline std::chrono::time_point<std::chrono::system_clock> read_clock() noexcept
+{
+    count(counter::clock_reads);
+    const auto mode = monotonic_mode.load(std::memory_order_relaxed);
+    std::chrono::time_point<std::chrono::system_clock> now;
+    switch (clock_source.load(std::memory_order_relaxed)) {
+        case ISODateTime::ClockSource::realtime_coarse: now = read_coarse_clock(); break;
+        case ISODateTime::ClockSource::tsc: now = read_tsc_clock(); break;
+        case ISODateTime::ClockSource::system:
+            if (mode == ISODateTime::MonotonicMode::off)
+                return std::chrono::system_clock::now();
+            now = read_steady_clock();
+            break;
+    }
+    if (mode == ISODateTime::MonotonicMode::off)
+        return now;
+    return advance_high_water(now, mode);
+}
+
+// ---------- Ticker ----------
+
+/**
+ * @brief The pair of timestamps published by the ticker on each tick.
+ */
+struct ticker_slot {
+    ISODateTime::IsoStamp local;
+    ISODateTime::IsoStamp utc;
+};
+
+inline seqlock_cell<ticker_slot> ticker_slots;
+inline std::atomic<bool> ticker_running{false};
+inline std::atomic<bool> ticker_serves_current{false};
+
+/**
+ * @brief Owner of the ticker thread; stops and joins it at static destruction.
+ */
+class ticker_thread {
+public:
+    ~ticker_thread() { stop(); }
+
+    /**
+     * @brief Publish the current time now, then start (or restart) the thread at a new resolution.
+     */
+    void start(std::chrono::nanoseconds resolution)
+    {
+        const std::lock_guard<std::mutex> control(control_);
+        stop_locked();
+        publish();
+        ticker_running.store(true, std::memory_order_release);
+        stopping_ = false;
+        thread_ = std::thread([this, resolution] { run(resolution); });
+    }
+
+    void stop()
+    {
+        const std::lock_guard<std::mutex> control(control_);
+        stop_locked();
+    }
+
+private:
+    /**
+     * @brief Render both timestamps once and publish them. Only the ticker thread (or start) writes.
+     */
+    static void publish() noexcept
+    {
+        const auto now = read_clock();
+        ticker_slots.store({ISODateTime::stamp(ISODateTime::Format::iso_date_timestamp, now),
+                            ISODateTime::stamp(ISODateTime::Format::utc_iso_date_timestamp, now)});
+    }
+
+    /**
+     * @brief Publish just after every multiple of resolution on system_clock, so each value is current for a whole tick.
+     */
+    void run(std::chrono::nanoseconds resolution)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            const auto now = std::chrono::system_clock::now();
+            const auto next = now - now.time_since_epoch() % resolution + resolution;
+            if (wake_.wait_until(lock, next, [this] { return stopping_; }))
+                break;
+            publish();
+        }
+    }
+
+    void stop_locked()
+    {
+        ticker_serves_current.store(false, std::memory_order_relaxed);
+        ticker_running.store(false, std::memory_order_release);
+        if (!thread_.joinable())
+            return;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    std::mutex control_; // serialises start and stop
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+inline ticker_thread ticker;
+
+/**
+ * @brief This thread's copy of the latest ticker_slot, re-read only when a new one is published.
+ */
+inline const ticker_slot& load_ticker_slot() noexcept
+{
+    count(counter::ticker_reads);
+    thread_local ticker_slot slot{};
+    thread_local std::uint32_t slot_version = 0;
+    if (ticker_slots.version() != slot_version)
+        slot = ticker_slots.load(&slot_version);
+    return slot;
+}
+
+/**
+ * @brief Copy published text of a known fixed length into a caller-supplied buffer.
+ *
+ * The length is a template parameter so the copy compiles to a few moves rather than a
+ * variable-length memcpy.
+ *
+ * @return Number of bytes written, or 0 if the buffer is too small or nothing renderable was published.
+ */
+template <std::size_t length>
+inline std::size_t copy_ticker_text(char* buffer, std::size_t size, const ISODateTime::IsoStamp& text) noexcept
+{
+    if (buffer == nullptr || text.length != length || length > size)
+        return 0;
+    std::memcpy(buffer, text.data, length);
+    return length;
+}
+
+// ---------- Digit kernel ----------
+
+/**
+ * @brief Render a std::tm into a caller-supplied buffer without any heap allocation.
+ *
+ * Emits YYYY-MM-DD, optionally followed by THH:MM:SS, a 3, 6 or 9 digit fraction and
+ * a 'Z' designator, using the two-digit lookup table instead of strftime. For years 0000-9999
+ * the output is identical to std::put_time with "%F" (date only) or "%FT%T" (with time),
+ * followed by the fraction and 'Z' when requested; years outside that range are not
+ * representable in the fixed-width format. Nothing is written unless the complete text fits;
+ * no null terminator is appended.
+ *
+ * @param buffer Destination buffer.
+ * @param size Capacity of the destination buffer in bytes.
+ * @param tm Broken-down time to render.
+ * @param with_time Whether to emit the THH:MM:SS part.
+ * @param fraction_digits Number of fraction digits to append: 0, 3, 6 or 9.
+ * @param nanoseconds Nanoseconds into the second, used when fraction_digits is non-zero.
+ * @param zulu Whether to append the 'Z' UTC designator.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is out of range.
+ */
+inline std::size_t write_iso_text(char* buffer, std::size_t size, const std::tm& tm, bool with_time,
+                                  unsigned fraction_digits, std::uint32_t nanoseconds, bool zulu) noexcept
+{
+    const std::size_t length = 10 + (with_time ? 9 : 0) + (fraction_digits != 0 ? fraction_digits + 1 : 0) + (zulu ? 1 : 0);
+    const long year = static_cast<long>(tm.tm_year) + 1900;
+    if (buffer == nullptr || length > size || year < 0 || year > 9999)
+        return 0;
+
+    char* out = buffer;
+    write_4_digits(out, static_cast<unsigned>(year));
+    out[4] = '-';
+    write_2_digits(out + 5, static_cast<unsigned>(tm.tm_mon + 1));
+    out[7] = '-';
+    write_2_digits(out + 8, static_cast<unsigned>(tm.tm_mday));
+    out += 10;
+    if (with_time) {
+        out[0] = 'T';
+        write_2_digits(out + 1, static_cast<unsigned>(tm.tm_hour));
+        out[3] = ':';
+        write_2_digits(out + 4, static_cast<unsigned>(tm.tm_min));
+        out[6] = ':';
+        write_2_digits(out + 7, static_cast<unsigned>(tm.tm_sec));
+        out += 9;
+    }
+    if (fraction_digits != 0) {
+        write_fraction(out, nanoseconds, fraction_digits);
+        out += fraction_digits + 1;
+    }
+    if (zulu)
+        *out = 'Z';
+    return length;
+}
+
+/**
+ * @brief Split a time_point into its epoch second and the nanoseconds into that second.
+ *
+ * The second is rounded towards negative infinity so that times before 1970 keep a
+ * non-negative fraction.
+ *
+ * @param time_point Time to split.
+ * @param nanoseconds Receives the nanoseconds into the second, 0-999999999.
+ * @return The epoch second containing time_point.
+ */
+inline std::time_t split_time_point(const std::chrono::time_point<std::chrono::system_clock>& time_point, std::uint32_t& nanoseconds) noexcept
+{
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(time_point);
+    nanoseconds = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - seconds).count());
+    return static_cast<std::time_t>(seconds.time_since_epoch().count());
+}
+
+/**
+ * @brief Write a UTC offset as +HH:MM or -HH:MM; seconds (historical local mean time only) are dropped.
+ * @param out Destination; must have room for 6 characters.
+ * @param offset Seconds east of UTC.
+ */
+inline void write_utc_offset(char* out, std::int32_t offset) noexcept
+{
+    out[0] = offset < 0 ? '-' : '+';
+    const auto magnitude = static_cast<std::uint32_t>(offset < 0 ? -static_cast<std::int64_t>(offset) : offset);
+    write_2_digits(out + 1, magnitude / 3600 % 100);
+    out[3] = ':';
+    write_2_digits(out + 4, magnitude / 60 % 60);
+}
+
+// ---------- Per-thread seconds cache ----------
+
+/**
+ * @brief A rendered "YYYY-MM-DDTHH:MM:SS" prefix together with the broken-down time it came from.
+ */
+struct cached_second {
+    std::time_t second{};
+    std::tm tm{};
+    char prefix[19]{};
+    std::size_t prefix_length{}; // 0 if the second is outside the renderable range
+    std::int32_t utc_offset{}; // seconds east of UTC of the rendered wall-clock time (0 for UTC)
+    bool filled{false};
+};
+
+/**
+ * @brief Portable replacement for tm_gmtoff: the wall-clock time in tm read as UTC, minus the actual UTC second.
+ * @param tm Broken-down wall-clock time of t.
+ * @param t The UTC second tm was converted from.
+ * @return Seconds east of UTC.
+ */
+inline std::int32_t tm_utc_offset(const std::tm& tm, std::time_t t) noexcept
+{
+    return static_cast<std::int32_t>(ISODateTime::days_from_civil(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1), static_cast<unsigned>(tm.tm_mday)) * 86400
+                                     + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec - static_cast<std::int64_t>(t));
+}
+
+/**
+ * @brief Return the per-thread cached rendering of an epoch second, refreshing it on a miss.
+ *
+ * The date/time prefix only changes once per second, so repeated calls within the same second
+ * skip the resolve_local_tm / to_utc_tm conversion and the digit rendering entirely and only the
+ * fraction and designator are written by the caller. Local and UTC are cached separately.
+ *
+ * @param seconds Epoch second to look up.
+ * @param utc Whether the UTC (true) or local (false) rendering is wanted.
+ * @return The cache entry for the given second; valid until the next call on this thread.
+ */
+inline const cached_second& get_cached_second(std::time_t seconds, bool utc)
+{
+    thread_local cached_second local_cache;
+    thread_local cached_second utc_cache;
+    auto& cache = utc ? utc_cache : local_cache;
+    if (cache.filled && cache.second == seconds) {
+        count(counter::second_cache_hits);
+        return cache;
+    }
+    count(counter::second_cache_misses);
+    phase_timer timer;
+    cache.tm = utc ? to_utc_tm(seconds) : resolve_local_tm(seconds);
+    timer.lap(counter::tm_conversion_ns);
+    cache.prefix_length = write_iso_text(cache.prefix, sizeof(cache.prefix), cache.tm, true, 0, 0, false);
+    timer.lap(counter::rendering_ns);
+    cache.utc_offset = tm_utc_offset(cache.tm, seconds);
+    cache.second = seconds;
+    cache.filled = true;
+    return cache;
+}
+
+/**
+ * @brief Write text from a cached prefix, patching in only the fraction and designator.
+ * @param buffer Destination buffer.
+ * @param size Capacity of the destination buffer in bytes.
+ * @param cache Cached rendering of the second being formatted.
+ * @param with_time Whether to emit the THH:MM:SS part of the prefix.
+ * @param fraction_digits Number of fraction digits to append: 0, 3, 6 or 9.
+ * @param nanoseconds Nanoseconds into the second, used when fraction_digits is non-zero.
+ * @param zulu Whether to append the 'Z' UTC designator.
+ * @param with_offset Whether to append the cached +HH:MM UTC offset instead.
+ * @return Number of bytes written, or 0 if the buffer is too small or the second is not renderable.
+ */
+inline std::size_t write_from_cache(char* buffer, std::size_t size, const cached_second& cache, bool with_time,
+                                    unsigned fraction_digits, std::uint32_t nanoseconds, bool zulu, bool with_offset = false) noexcept
+{
+    const std::size_t prefix_length = with_time ? 19 : 10;
+    const std::size_t length = prefix_length + (fraction_digits != 0 ? fraction_digits + 1 : 0) + (zulu ? 1 : 0) + (with_offset ? 6 : 0);
+    if (buffer == nullptr || length > size || cache.prefix_length == 0)
+        return 0;
+
+    std::memcpy(buffer, cache.prefix, prefix_length);
+    char* out = buffer + prefix_length;
+    if (fraction_digits != 0) {
+        write_fraction(out, nanoseconds, fraction_digits);
+        out += fraction_digits + 1;
+    }
+    if (zulu)
+        *out = 'Z';
+    else if (with_offset)
+        write_utc_offset(out, cache.utc_offset);
+    return length;
+}
+
+// ---------- Daily date cache ----------
+
+/**
+ * @brief A day rendered as a calendar, week and ordinal date, together with the UTC seconds it applies to.
+ */
+struct daily_date {
+    std::int64_t valid_from; // first UTC second the text applies to
+    std::int64_t valid_until; // first UTC second it no longer applies to; equal to valid_from when empty
+    char text[10]; // YYYY-MM-DD
+    char week_date[10]; // YYYY-Www-D
+    char ordinal_date[8]; // YYYY-DDD
+};
+
+/**
+ * @brief Which rendering of the day write_daily_date copies out.
+ */
+enum class daily_text : std::uint8_t {
+    calendar,
+    week,
+    ordinal,
+};
+
+/**
+ * @brief Write the week or ordinal date of a broken-down time with the arithmetic calendar core.
+ * @param out Destination; must have room for 10 (week) or 8 (ordinal) characters.
+ * @param tm Broken-down wall-clock time; its calendar year must be in 0000-9999.
+ * @param which daily_text::week or daily_text::ordinal.
+ * @return Number of bytes written, or 0 if the year is not renderable.
+ */
+inline std::size_t write_tm_calendar_text(char* out, const std::tm& tm, daily_text which) noexcept
+{
+    const std::int64_t year = tm.tm_year + 1900;
+    if (year < 0 || year > 9999)
+        return 0;
+    if (which == daily_text::ordinal) {
+        write_ordinal_date(out, year, static_cast<unsigned>(tm.tm_yday + 1));
+        return 8;
+    }
+    // The week-numbering year can be one off the calendar year around New Year
+    const auto date = ISODateTime::week_date_from_days(ISODateTime::days_from_civil(year, static_cast<unsigned>(tm.tm_mon + 1), static_cast<unsigned>(tm.tm_mday)));
+    if (date.year < 0 || date.year > 9999)
+        return 0;
+    write_week_date(out, date);
+    return 10;
+}
+
+inline seqlock_cell<daily_date> daily_dates[2]; // indexed by utc: local, UTC
+inline std::mutex daily_dates_writer; // serialises publication; losers of the try_lock never wait
+
+/**
+ * @brief Build the daily_date containing t.
+ *
+ * The UTC day is exactly [midnight, midnight + 86400). For local time the day is cut at the
+ * local midnights computed with the offset in force at t; if the offset differs at either end
+ * the window is narrowed conservatively (to start at t, or to end at the first second with a
+ * different offset, found by bisection), so DST shifts and zones whose transitions fall at
+ * midnight are never served a stale date. A second lookup simply rebuilds the next window.
+ *
+ * @param t UTC second the date must cover.
+ * @param utc Whether the UTC (true) or local (false) date is wanted.
+ * @return The entry, or an empty one if the year is not renderable.
+ */
+inline daily_date build_daily_date(std::time_t t, bool utc)
+{
+    daily_date date{};
+    const std::tm tm = utc ? to_utc_tm(t) : resolve_local_tm(t);
+    if (write_iso_text(date.text, sizeof(date.text), tm, false, 0, 0, false) == 0
+        || write_tm_calendar_text(date.week_date, tm, daily_text::week) == 0)
+        return date;
+    write_tm_calendar_text(date.ordinal_date, tm, daily_text::ordinal);
+
+    const std::int64_t second = t;
+    const std::int64_t midnight = second - (tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec);
+    date.valid_from = midnight;
+    date.valid_until = midnight + 86400;
+    if (!utc) {
+        const auto offset = tm_utc_offset(tm, t);
+        const auto offset_at = [](std::int64_t s) {
+            const auto x = static_cast<std::time_t>(s);
+            return tm_utc_offset(resolve_local_tm(x), x);
+        };
+        if (offset_at(date.valid_from) != offset)
+            date.valid_from = second;
+        if (offset_at(date.valid_until - 1) != offset) {
+            std::int64_t same = second; // offset at same == offset, offset at changed != offset
+            std::int64_t changed = date.valid_until - 1;
+            while (changed - same > 1) {
+                const std::int64_t mid = same + (changed - same) / 2;
+                (offset_at(mid) == offset ? same : changed) = mid;
+            }
+            date.valid_until = changed;
+        }
+    }
+    return date;
+}
+
+/**
+ * @brief Write the local or UTC date of t from the process-wide daily cache.
+ *
+ * Readers compare t against this thread's copy of the published entry, re-reading the seqlock
+ * only when its version changes, so the steady state is a range check and a 10-byte copy. The
+ * cell only ever holds the current day: a miss rebuilds it only when the published entry no
+ * longer covers the clock and t is within a day of it, and the result is published only if it
+ * covers the clock. Exactly one thread rebuilds, with all three renderings, so the week number
+ * is worked out once per day. Other days, and threads that lose the try_lock, format from the
+ * per-thread seconds cache without touching the lock or the shared cell, so historical or
+ * mixed-day records never evict today and the day boundary cannot pile callers up behind one lock.
+ *
+ * The clock is only consulted when t did not come from it and is within a day of the published
+ * entry (or nothing is published yet, at most once every 1024 misses per thread), so records
+ * from other days cost no clock read.
+ *
+ * @param t_is_now Whether t was just read from the clock, so it is the current second.
+ * @param which Calendar (YYYY-MM-DD), week (YYYY-Www-D) or ordinal (YYYY-DDD) date.
+ * @return Number of bytes written, or 0 if the buffer is too small or the date is not renderable.
+ */
+inline std::size_t write_daily_date(char* buffer, std::size_t size, std::time_t t, bool utc, bool t_is_now, daily_text which = daily_text::calendar) noexcept
+{
+    const std::size_t length = which == daily_text::ordinal ? 8 : 10;
+    if (buffer == nullptr || size < length)
+        return 0;
+
+    thread_local daily_date copies[2]{};
+    thread_local std::uint32_t copy_versions[2]{};
+    auto& cell = daily_dates[utc];
+    auto& copy = copies[utc];
+    auto& copy_version = copy_versions[utc];
+    if (cell.version() != copy_version)
+        copy = cell.load(&copy_version);
+
+    const auto write_text = [&](const daily_date& date) {
+        switch (which) {
+            case daily_text::calendar: std::memcpy(buffer, date.text, 10); break;
+            case daily_text::week: std::memcpy(buffer, date.week_date, 10); break;
+            case daily_text::ordinal: std::memcpy(buffer, date.ordinal_date, 8); break;
+        }
+        return length;
+    };
+    const auto write_uncached = [&] {
+        const auto& cache = get_cached_second(t, utc);
+        if (which != daily_text::calendar)
+            return cache.prefix_length == 0 ? 0 : write_tm_calendar_text(buffer, cache.tm, which);
+        return write_from_cache(buffer, size, cache, false, 0, 0, false);
+    };
+
+    const std::int64_t second = t;
+    if (second >= copy.valid_from && second < copy.valid_until) {
+        count(counter::date_cache_hits);
+        return write_text(copy);
+    }
+    count(counter::date_cache_misses);
+    std::int64_t now = second;
+    if (!t_is_now) {
+        const bool published = copy.valid_until != copy.valid_from;
+        if (published && (second < copy.valid_from - 86400 || second >= copy.valid_until + 86400))
+            return write_uncached();
+        thread_local std::uint32_t unpublished_misses = 0;
+        if (!published && (unpublished_misses++ & 1023) != 0)
+            return write_uncached();
+        now = std::chrono::system_clock::to_time_t(peek_clock());
+    }
+    const bool published_is_current = now >= copy.valid_from && now < copy.valid_until;
+    if (published_is_current || second < now - 86400 || second > now + 86400)
+        return write_uncached();
+    std::unique_lock<std::mutex> lock(daily_dates_writer, std::try_to_lock);
+    if (!lock.owns_lock())
+        return write_uncached();
+    const daily_date date = build_daily_date(t, utc);
+    if (date.valid_until == date.valid_from)
+        return 0;
+    if (now >= date.valid_from && now < date.valid_until) {
+        cell.store(date);
+        copy = date;
+        copy_version = cell.version();
+    }
+    return write_text(date);
+}
+
+/**
+ * @brief Drop the published local date, e.g. after the local zone changed.
+ */
+inline void clear_local_daily_date() noexcept
+{
+    const std::lock_guard<std::mutex> lock(daily_dates_writer);
+    daily_dates[0].store(daily_date{});
+}
+
+// ---------- Format selection ----------
+
+/**
+ * @brief What a Format is made of.
+ */
+struct format_layout {
+    bool utc;
+    bool with_time;
+    unsigned fraction_digits; // 0, 3, 6 or 9
+    bool zulu; // 'Z' designator; UTC dates carry none, matching get_current_utc_iso_date
+    bool offset; // +HH:MM suffix with the local UTC offset
+};
+
+/**
+ * @brief Decompose a Format into its layout.
+ */
+constexpr format_layout get_format_layout(ISODateTime::Format format) noexcept
+{
+    switch (format) {
+        case ISODateTime::Format::iso_date: return {false, false, 0, false, false};
+        case ISODateTime::Format::iso_date_time: return {false, true, 0, false, false};
+        case ISODateTime::Format::iso_date_timestamp: return {false, true, 3, false, false};
+        case ISODateTime::Format::iso_date_timestamp_us: return {false, true, 6, false, false};
+        case ISODateTime::Format::iso_date_timestamp_ns: return {false, true, 9, false, false};
+        case ISODateTime::Format::utc_iso_date: return {true, false, 0, false, false};
+        case ISODateTime::Format::utc_iso_date_time: return {true, true, 0, true, false};
+        case ISODateTime::Format::utc_iso_date_timestamp: return {true, true, 3, true, false};
+        case ISODateTime::Format::utc_iso_date_timestamp_us: return {true, true, 6, true, false};
+        case ISODateTime::Format::utc_iso_date_timestamp_ns: return {true, true, 9, true, false};
+        case ISODateTime::Format::iso_date_time_offset: return {false, true, 0, false, true};
+        case ISODateTime::Format::iso_date_timestamp_offset: return {false, true, 3, false, true};
+        case ISODateTime::Format::iso_date_timestamp_us_offset: return {false, true, 6, false, true};
+        case ISODateTime::Format::iso_date_timestamp_ns_offset: return {false, true, 9, false, true};
+    }
+    return {true, true, 3, true, false};
+}
+
+/**
+ * @brief Fewest records format_batch_parallel hands to a thread; below this a thread start costs more than it saves.
+ */
+inline constexpr std::size_t parallel_batch_min_records = 16384;
+
+// ---------- Format plans ----------
+
+/**
+ * @brief Copy up to a few dozen bytes with fixed-size, possibly overlapping, word copies.
+ *
+ * A variable-length std::memcpy of short text is expanded by GCC into rep movs, which costs more
+ * than the whole plan; fixed-size copies compile to plain moves, and the last word is copied
+ * ending exactly at length so there is no byte tail.
+ */
+inline void copy_short_text(char* out, const char* in, std::size_t length) noexcept
+{
+    if (length >= 8) {
+        std::memcpy(out + length - 8, in + length - 8, 8);
+        for (; length > 8; length -= 8, out += 8, in += 8)
+            std::memcpy(out, in, 8);
+    } else if (length >= 4) {
+        std::memcpy(out, in, 4);
+        std::memcpy(out + length - 4, in + length - 4, 4);
+    } else if (length != 0) {
+        out[0] = in[0];
+        out[length / 2] = in[length / 2];
+        out[length - 1] = in[length - 1];
+    }
+}
+
+/**
+ * @brief Write text for a compiled FormatPlan from a cached second.
+ * @param buffer Destination buffer.
+ * @param size Capacity of the destination buffer in bytes.
+ * @param plan Compiled pattern.
+ * @param cache Cached rendering of the second being formatted (local or UTC, as plan.utc says).
+ * @param nanoseconds Nanoseconds into the second, used by fraction fields.
+ * @return Number of bytes written (plan.length), or 0 if the buffer is too small or the second is not renderable.
+ */
+inline std::size_t write_planned_text(char* buffer, std::size_t size, const ISODateTime::FormatPlan& plan, const cached_second& cache, std::uint32_t nanoseconds) noexcept
+{
+    using Field = ISODateTime::FormatPlan::Field;
+    if (buffer == nullptr || plan.length > size || cache.prefix_length == 0)
+        return 0;
+
+    copy_short_text(buffer, plan.text, plan.length);
+    for (std::size_t i = 0; i < plan.step_count; ++i) {
+        const auto& step = plan.steps[i];
+        char* out = buffer + step.out;
+        switch (step.field) {
+            case Field::prefix:
+                copy_short_text(out, cache.prefix + step.source, step.width);
+                break;
+            case Field::fraction: {
+                char digits[9];
+                write_3_digits(digits, nanoseconds / 1000000);
+                write_3_digits(digits + 3, nanoseconds / 1000 % 1000);
+                write_3_digits(digits + 6, nanoseconds % 1000);
+                copy_short_text(out, digits, step.width);
+                break;
+            }
+            case Field::day_of_year:
+                write_3_digits(out, static_cast<unsigned>(cache.tm.tm_yday + 1));
+                break;
+            case Field::weekday:
+                *out = static_cast<char>(cache.tm.tm_wday == 0 ? '7' : '0' + cache.tm.tm_wday);
+                break;
+            case Field::offset: {
+                char offset[6];
+                write_utc_offset(offset, cache.utc_offset);
+                std::memcpy(out, offset, 3);
+                std::memcpy(out + 3, offset + 4, 2);
+                break;
+            }
+            case Field::offset_colon:
+                write_utc_offset(out, cache.utc_offset);
+                break;
+        }
+    }
+    return plan.length;
+}
+
+// ---------- Compact times ----------
+
+/**
+ * @brief Render a CompactTime: UTC formats from the instant, local formats from the instant plus the captured offset.
+ *
+ * Local rendering needs no zone lookup, so it gives the wall-clock time of the capture even if
+ * the zone rules change later. A capture with compact_unknown_offset is resolved with the
+ * current local zone instead.
+ *
+ * @param length formatted_length of the format the layout came from.
+ * @return Number of bytes written, or 0 if the buffer is too small or the time is not renderable.
+ */
+inline std::size_t write_compact_text(char* buffer, std::size_t size, const format_layout& layout, std::size_t length, const ISODateTime::CompactTime& time) noexcept
+{
+    if (buffer == nullptr || size < length)
+        return 0;
+    std::int64_t seconds = time.nanoseconds / 1000000000;
+    std::int64_t remainder = time.nanoseconds % 1000000000;
+    if (remainder < 0) {
+        seconds -= 1;
+        remainder += 1000000000;
+    }
+    const auto nanoseconds = static_cast<std::uint32_t>(remainder);
+
+    if (layout.utc)
+        return write_from_cache(buffer, size, get_cached_second(static_cast<std::time_t>(seconds), true), layout.with_time, layout.fraction_digits, nanoseconds, layout.zulu);
+    if (time.offset_quarters == ISODateTime::compact_unknown_offset)
+        return write_from_cache(buffer, size, get_cached_second(static_cast<std::time_t>(seconds), false), layout.with_time, layout.fraction_digits, nanoseconds, false, layout.offset);
+
+    // The wall-clock second rendered without a designator is exactly the local text
+    const std::int32_t offset = time.offset_quarters * 900;
+    const std::size_t written = write_from_cache(buffer, size, get_cached_second(static_cast<std::time_t>(seconds + offset), true), layout.with_time, layout.fraction_digits, nanoseconds, false);
+    if (written == 0 || !layout.offset)
+        return written;
+    write_utc_offset(buffer + written, offset);
+    return written + 6;
+}
+
+// ---------- Durations ----------
+
+/**
+ * @brief Write an unsigned value in decimal, two digits at a time.
+ * @param out Destination; must have room for 20 characters.
+ * @return Number of digits written.
+ */
+inline std::size_t write_decimal(char* out, std::uint64_t value) noexcept
+{
+    char digits[20];
+    char* p = digits + sizeof(digits);
+    while (value >= 100) {
+        p -= 2;
+        write_2_digits(p, static_cast<unsigned>(value % 100));
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        write_2_digits(p, static_cast<unsigned>(value));
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    const auto length = static_cast<std::size_t>(digits + sizeof(digits) - p);
+    std::memcpy(out, p, length);
+    return length;
+}
+
+/**
+ * @brief Write a nanosecond count as an ISO 8601 duration: days, hours, minutes and seconds,
+ *        zero parts left out and the fraction trimmed of trailing zeros.
+ * @param out Destination; must have room for ISODateTime::iso_duration_max_length characters.
+ * @param nanoseconds Duration; negative values get a leading '-'.
+ * @return Number of characters written.
+ */
+inline std::size_t write_iso_duration(char* out, std::int64_t nanoseconds) noexcept
+{
+    char* p = out;
+    if (nanoseconds < 0)
+        *p++ = '-';
+    *p++ = 'P';
+    // Unsigned negation keeps the most negative value exact
+    const std::uint64_t magnitude = nanoseconds < 0 ? 0 - static_cast<std::uint64_t>(nanoseconds) : static_cast<std::uint64_t>(nanoseconds);
+    const std::uint64_t seconds = magnitude / 1000000000;
+    const auto fraction = static_cast<std::uint32_t>(magnitude % 1000000000);
+    const std::uint64_t days = seconds / 86400;
+    const auto second_of_day = static_cast<unsigned>(seconds % 86400);
+    const unsigned hours = second_of_day / 3600;
+    const unsigned minutes = second_of_day / 60 % 60;
+    const unsigned whole_seconds = second_of_day % 60;
+
+    if (days != 0) {
+        p += write_decimal(p, days);
+        *p++ = 'D';
+    }
+    if (second_of_day == 0 && fraction == 0 && days != 0)
+        return static_cast<std::size_t>(p - out);
+    *p++ = 'T';
+    if (hours != 0) {
+        p += write_decimal(p, hours);
+        *p++ = 'H';
+    }
+    if (minutes != 0) {
+        p += write_decimal(p, minutes);
+        *p++ = 'M';
+    }
+    if (whole_seconds != 0 || fraction != 0 || second_of_day == 0) {
+        p += write_decimal(p, whole_seconds);
+        if (fraction != 0) {
+            write_fraction(p, fraction, 9);
+            std::size_t fraction_length = 10;
+            while (p[fraction_length - 1] == '0')
+                --fraction_length;
+            p += fraction_length;
+        }
+        *p++ = 'S';
+    }
+    return static_cast<std::size_t>(p - out);
+}
+
+/**
+ * @brief Parse an ISO 8601 duration into nanoseconds.
+ *
+ * Accepted: an optional sign, 'P', then any of nW nD in that order, then optionally 'T' and any
+ * of nH nM nS in that order, with at least one part overall. The last part may carry a
+ * fraction after '.' or ',' (with a digit before it); digits past the ninth are dropped. Years
+ * and months have no fixed length and are rejected, as is anything that does not fit in a
+ * nanoseconds count.
+ *
+ * @param text Text to parse.
+ * @param nanoseconds Receives the duration.
+ * @return true if text is a duration of that form.
+ */
+inline bool parse_iso_duration_text(std::string_view text, std::int64_t& nanoseconds) noexcept
+{
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    const bool negative = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+'))
+        ++p;
+    if (p == end || *p++ != 'P')
+        return false;
+
+    constexpr std::uint64_t second = 1000000000;
+    const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + (negative ? 1 : 0);
+    std::uint64_t total = 0;
+    int last_rank = -1;
+    bool in_time = false;
+    bool any_part = false;
+    while (p != end) {
+        if (*p == 'T' && !in_time) {
+            in_time = true;
+            ++p;
+            if (p == end)
+                return false;
+            continue;
+        }
+
+        // Whole part, then an optional fraction of up to nine significant digits
+        std::uint64_t value = 0;
+        const char* digits = p;
+        for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+            const auto digit = static_cast<unsigned>(*p - '0');
+            if (value > (std::numeric_limits<std::uint64_t>::max() - digit) / 10)
+                return false;
+            value = value * 10 + digit;
+        }
+        const bool has_whole = p != digits;
+        std::uint64_t fraction = 0;
+        unsigned fraction_digits = 0;
+        bool has_fraction = false;
+        if (p != end && (*p == '.' || *p == ',')) {
+            has_fraction = true;
+            for (++p; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+                if (fraction_digits < 9) {
+                    fraction = fraction * 10 + static_cast<unsigned>(*p - '0');
+                    ++fraction_digits;
+                }
+            }
+            if (fraction_digits == 0)
+                return false;
+        }
+        if (!has_whole || p == end)
+            return false;
+
+        int rank = 0;
+        std::uint64_t unit = 0;
+        switch (*p++) {
+            case 'W': rank = 0; unit = 7 * 86400 * second; break;
+            case 'D': rank = 1; unit = 86400 * second; break;
+            case 'H': rank = 2; unit = 3600 * second; break;
+            case 'M': rank = 3; unit = 60 * second; break;
+            case 'S': rank = 4; unit = second; break;
+            default: return false;
+        }
+        // W and D belong before the T, H M S after it; each at most once, largest first
+        if ((rank >= 2) != in_time || rank <= last_rank || (has_fraction && p != end))
+            return false;
+        last_rank = rank;
+        any_part = true;
+
+        // Every unit is a whole number of seconds, so unit / 10^digits is exact for up to nine digits
+        std::uint64_t scale = 1;
+        for (unsigned i = 0; i < fraction_digits; ++i)
+            scale *= 10;
+        const std::uint64_t fraction_part = fraction * (unit / scale);
+        if (value > (limit - total) / unit)
+            return false;
+        total += value * unit;
+        if (fraction_part > limit - total)
+            return false;
+        total += fraction_part;
+    }
+    if (!any_part)
+        return false;
+    nanoseconds = negative ? static_cast<std::int64_t>(0 - total) : static_cast<std::int64_t>(total);
+    return true;
+}
+
+/**
+ * @brief time_point + nanoseconds, or std::nullopt if the result does not fit the clock.
+ */
+inline std::optional<std::chrono::time_point<std::chrono::system_clock>> add_duration(const std::chrono::time_point<std::chrono::system_clock>& time_point,
+                                                                                        std::int64_t nanoseconds) noexcept
+{
+    using duration = std::chrono::system_clock::duration;
+    const auto ticks = std::chrono::duration_cast<duration>(std::chrono::nanoseconds(nanoseconds)).count();
+    const auto base = time_point.time_since_epoch().count();
+    if ((ticks > 0 && base > std::numeric_limits<duration::rep>::max() - ticks) || (ticks < 0 && base < std::numeric_limits<duration::rep>::min() - ticks))
+        return std::nullopt;
+    return std::chrono::time_point<std::chrono::system_clock>(duration(base + ticks));
+}
+
+// ---------- Time zones ----------
+
+/**
+ * @brief The date part of a POSIX TZ rule: Mm.w.d, Jn (1-365, never counting February 29) or n (0-365).
+ */
+struct posix_date_rule {
+    char kind; // 'M', 'J' or 'n'
+    unsigned month; // 'M': 1-12
+    unsigned week; // 'M': 1-5, 5 meaning the last
+    unsigned weekday; // 'M': 0 (Sunday) - 6
+    unsigned day; // 'J' and 'n'
+    std::int32_t time; // local seconds after midnight; may be negative or exceed 24 hours
+};
+
+/**
+ * @brief A parsed POSIX TZ string such as "CET-1CEST,M3.5.0,M10.5.0/3", used past the end of the TZif data.
+ */
+struct posix_zone_rule {
+    std::int32_t std_offset; // seconds east of UTC
+    std::int32_t dst_offset;
+    bool has_dst;
+    posix_date_rule start; // DST begins, in standard time
+    posix_date_rule end; // DST ends, in daylight time
+};
+
+/**
+ * @brief An immutable zone loaded from tzdata, plus the window of the last offset lookup.
+ *
+ * Entry i of the table applies from starts[i] up to starts[i + 1]; starts[0] is the minimum
+ * int64 so every second falls into some entry. Rule transitions are expanded into the table up
+ * to rule_from, after which the POSIX rule is evaluated directly.
+ */
+struct time_zone {
+    std::string name;
+    std::vector<std::int64_t> starts;
+    std::vector<std::int32_t> offsets;
+    std::int64_t rule_from{std::numeric_limits<std::int64_t>::max()};
+    posix_zone_rule rule{};
+    mutable std::atomic<std::uint32_t> last_index{0};
+};
+
+/**
+ * @brief Last year whose rule transitions are expanded into a zone's table.
+ */
+inline constexpr std::int64_t zone_table_last_year = 2100;
+
+inline std::map<std::string, std::unique_ptr<time_zone>, std::less<>> zones;
+inline std::mutex zones_writer;
+
+/**
+ * @brief Read an unsigned decimal number of at most max_digits digits.
+ */
+inline bool read_posix_number(const char*& p, const char* end, unsigned max_digits, unsigned& value) noexcept
+{
+    value = 0;
+    unsigned digits = 0;
+    while (p < end && *p >= '0' && *p <= '9' && digits < max_digits) {
+        value = value * 10 + static_cast<unsigned>(*p++ - '0');
+        ++digits;
+    }
+    return digits != 0;
+}
+
+/**
+ * @brief Skip a zone abbreviation: three or more letters, or any text in angle brackets.
+ */
+inline bool skip_posix_name(const char*& p, const char* end) noexcept
+{
+    if (p < end && *p == '<') {
+        while (p < end && *p != '>')
+            ++p;
+        if (p == end)
+            return false;
+        ++p;
+        return true;
+    }
+    const char* begin = p;
+    while (p < end && ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')))
+        ++p;
+    return p - begin >= 3;
+}
+
+/**
+ * @brief Read [+-]hh[:mm[:ss]] as signed seconds.
+ */
+inline bool read_posix_time(const char*& p, const char* end, std::int32_t& seconds) noexcept
+{
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = *p++ == '-';
+    unsigned hours = 0, minutes = 0, secs = 0;
+    if (!read_posix_number(p, end, 3, hours) || hours > 167)
+        return false;
+    if (p < end && *p == ':') {
+        ++p;
+        if (!read_posix_number(p, end, 2, minutes) || minutes > 59)
+            return false;
+        if (p < end && *p == ':') {
+            ++p;
+            if (!read_posix_number(p, end, 2, secs) || secs > 59)
+                return false;
+        }
+    }
+    const auto magnitude = static_cast<std::int32_t>(hours * 3600 + minutes * 60 + secs);
+    seconds = negative ? -magnitude : magnitude;
+    return true;
+}
+
+/**
+ * @brief Read a rule date with its optional /time (default 02:00:00).
+ */
+inline bool read_posix_date(const char*& p, const char* end, posix_date_rule& rule) noexcept
+{
+    rule = posix_date_rule{};
+    if (p < end && *p == 'M') {
+        ++p;
+        rule.kind = 'M';
+        if (!read_posix_number(p, end, 2, rule.month) || rule.month < 1 || rule.month > 12 || p == end || *p++ != '.'
+            || !read_posix_number(p, end, 1, rule.week) || rule.week < 1 || rule.week > 5 || p == end || *p++ != '.'
+            || !read_posix_number(p, end, 1, rule.weekday) || rule.weekday > 6)
+            return false;
+    } else if (p < end && *p == 'J') {
+        ++p;
+        rule.kind = 'J';
+        if (!read_posix_number(p, end, 3, rule.day) || rule.day < 1 || rule.day > 365)
+            return false;
+    } else {
+        rule.kind = 'n';
+        if (!read_posix_number(p, end, 3, rule.day) || rule.day > 365)
+            return false;
+    }
+    rule.time = 7200;
+    if (p < end && *p == '/') {
+        ++p;
+        return read_posix_time(p, end, rule.time);
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a POSIX TZ string ("std offset [dst [offset] [,start[/time],end[/time]]]").
+ *
+ * Offsets in the string count hours west of UTC; the parsed rule stores seconds east. A DST
+ * name without dates uses the US rules, as glibc does.
+ *
+ * @return false if the text is not a valid TZ string.
+ */
+inline bool parse_posix_zone_rule(std::string_view text, posix_zone_rule& rule) noexcept
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+    rule = posix_zone_rule{};
+    std::int32_t west = 0;
+    if (!skip_posix_name(p, end) || !read_posix_time(p, end, west))
+        return false;
+    rule.std_offset = -west;
+    if (p == end)
+        return true;
+
+    if (!skip_posix_name(p, end))
+        return false;
+    rule.has_dst = true;
+    rule.dst_offset = rule.std_offset + 3600;
+    if (p < end && *p != ',') {
+        if (!read_posix_time(p, end, west))
+            return false;
+        rule.dst_offset = -west;
+    }
+    if (p == end) {
+        rule.start = {'M', 3, 2, 0, 0, 7200};
+        rule.end = {'M', 11, 1, 0, 0, 7200};
+        return true;
+    }
+    if (*p++ != ',' || !read_posix_date(p, end, rule.start) || p == end || *p++ != ',' || !read_posix_date(p, end, rule.end))
+        return false;
+    return p == end;
+}
+
+/**
+ * @brief Days since 1970-01-01 of the local date a rule date falls on in a year.
+ */
+constexpr std::int64_t posix_rule_day(const posix_date_rule& rule, std::int64_t year) noexcept
+{
+    const std::int64_t january_first = ISODateTime::days_from_civil(year, 1, 1);
+    if (rule.kind == 'n')
+        return january_first + rule.day;
+    if (rule.kind == 'J') {
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return january_first + rule.day - 1 + (leap && rule.day >= 60 ? 1 : 0);
+    }
+    const std::int64_t first = ISODateTime::days_from_civil(year, rule.month, 1);
+    const std::int64_t next_month = rule.month == 12 ? ISODateTime::days_from_civil(year + 1, 1, 1) : ISODateTime::days_from_civil(year, rule.month + 1, 1);
+    const std::int64_t first_weekday = ((first % 7) + 11) % 7; // 1970-01-01 was a Thursday
+    std::int64_t day = first + (static_cast<std::int64_t>(rule.weekday) - first_weekday + 7) % 7 + (static_cast<std::int64_t>(rule.week) - 1) * 7;
+    while (day >= next_month)
+        day -= 7;
+    return day;
+}
+
+/**
+ * @brief UTC seconds at which DST begins and ends in a year under a rule.
+ */
+constexpr void posix_rule_transitions(const posix_zone_rule& rule, std::int64_t year, std::int64_t& dst_begins, std::int64_t& dst_ends) noexcept
+{
+    dst_begins = posix_rule_day(rule.start, year) * 86400 + rule.start.time - rule.std_offset;
+    dst_ends = posix_rule_day(rule.end, year) * 86400 + rule.end.time - rule.dst_offset;
+}
+
+/**
+ * @brief UTC offset under a rule at a UTC second.
+ */
+constexpr std::int32_t posix_rule_offset(const posix_zone_rule& rule, std::int64_t t) noexcept
+{
+    if (!rule.has_dst)
+        return rule.std_offset;
+    const std::int64_t local = t + rule.std_offset;
+    const std::int64_t year = ISODateTime::civil_from_days((local >= 0 ? local : local - 86399) / 86400).year;
+    std::int64_t dst_begins = 0, dst_ends = 0;
+    posix_rule_transitions(rule, year, dst_begins, dst_ends);
+    if (dst_begins < dst_ends)
+        return t >= dst_begins && t < dst_ends ? rule.dst_offset : rule.std_offset;
+    return t >= dst_ends && t < dst_begins ? rule.std_offset : rule.dst_offset; // southern hemisphere
+}
+
+/**
+ * @brief Append an offset change to a zone's table, dropping changes that keep the same offset.
+ */
+inline void append_zone_transition(time_zone& zone, std::int64_t start, std::int32_t offset)
+{
+    if (offset == zone.offsets.back())
+        return;
+    if (start <= zone.starts.back()) {
+        zone.offsets.back() = offset;
+        return;
+    }
+    zone.starts.push_back(start);
+    zone.offsets.push_back(offset);
+}
+
+/**
+ * @brief Read a big-endian integer of N bytes.
+ */
+template <std::size_t N>
+inline std::uint64_t read_big_endian(const unsigned char* p) noexcept
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < N; ++i)
+        value = value << 8 | p[i];
+    return value;
+}
+
+/**
+ * @brief Parse TZif data (RFC 8536, versions 1-4) into a zone's offset table.
+ *
+ * The 64-bit second part is used when present, and its POSIX TZ footer is expanded into the
+ * table up to zone_table_last_year. Files with leap-second records ("right/" zones) are rejected.
+ *
+ * @return false if the data is not valid TZif.
+ */
+inline bool parse_tzif(const unsigned char* data, std::size_t size, time_zone& zone)
+{
+    constexpr std::size_t header_size = 44;
+    const auto read_header = [&](std::size_t at, std::uint32_t (&counts)[6]) {
+        if (size < at + header_size || std::memcmp(data + at, "TZif", 4) != 0)
+            return false;
+        for (std::size_t i = 0; i < 6; ++i)
+            counts[i] = static_cast<std::uint32_t>(read_big_endian<4>(data + at + 20 + i * 4));
+        return true;
+    };
+    const auto block_size = [](const std::uint32_t (&counts)[6], std::size_t time_size) {
+        // isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt
+        return static_cast<std::size_t>(counts[3]) * (time_size + 1) + static_cast<std::size_t>(counts[4]) * 6 + counts[5]
+               + static_cast<std::size_t>(counts[2]) * (time_size + 4) + counts[1] + counts[0];
+    };
+
+    std::uint32_t counts[6];
+    if (!read_header(0, counts))
+        return false;
+    std::size_t at = header_size;
+    std::size_t time_size = 4;
+    if (data[4] >= '2') {
+        at += block_size(counts, 4);
+        if (!read_header(at, counts))
+            return false;
+        at += header_size;
+        time_size = 8;
+    }
+    const std::uint32_t leap_count = counts[2], time_count = counts[3], type_count = counts[4];
+    if (type_count == 0 || leap_count != 0 || size < at + block_size(counts, time_size))
+        return false;
+
+    const unsigned char* times = data + at;
+    const unsigned char* indices = times + static_cast<std::size_t>(time_count) * time_size;
+    const unsigned char* types = indices + time_count;
+    const auto type_offset = [&](std::size_t type) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(read_big_endian<4>(types + type * 6))); };
+
+    zone.starts.assign(1, std::numeric_limits<std::int64_t>::min());
+    zone.offsets.assign(1, type_offset(0));
+    for (std::uint32_t i = 0; i < time_count; ++i) {
+        const std::uint64_t raw = time_size == 8 ? read_big_endian<8>(times + i * 8) : read_big_endian<4>(times + i * 4);
+        const std::int64_t start = time_size == 8 ? static_cast<std::int64_t>(raw) : static_cast<std::int32_t>(static_cast<std::uint32_t>(raw));
+        if (indices[i] >= type_count || start <= zone.starts.back())
+            return false;
+        append_zone_transition(zone, start, type_offset(indices[i]));
+    }
+
+    if (time_size == 8) {
+        const char* footer = reinterpret_cast<const char*>(data + at + block_size(counts, time_size));
+        const char* data_end = reinterpret_cast<const char*>(data + size);
+        if (footer < data_end && *footer == '\n') {
+            const char* footer_end = std::find(footer + 1, data_end, '\n');
+            posix_zone_rule rule{};
+            if (footer_end != data_end && footer_end != footer + 1 && parse_posix_zone_rule({footer + 1, static_cast<std::size_t>(footer_end - footer - 1)}, rule)) {
+                zone.rule = rule;
+                if (!rule.has_dst) {
+                    // The footer governs from the last transition on (all time if there is none)
+                    append_zone_transition(zone, zone.starts.back(), rule.std_offset);
+                } else {
+                    const std::int64_t last = zone.starts.size() > 1 ? zone.starts.back() : 0;
+                    const std::int64_t first_year = ISODateTime::civil_from_days((last >= 0 ? last : last - 86399) / 86400).year;
+                    for (std::int64_t year = first_year; year <= zone_table_last_year; ++year) {
+                        std::int64_t dst_begins = 0, dst_ends = 0;
+                        posix_rule_transitions(rule, year, dst_begins, dst_ends);
+                        const bool begins_first = dst_begins < dst_ends;
+                        const std::int64_t first = begins_first ? dst_begins : dst_ends;
+                        const std::int64_t second = begins_first ? dst_ends : dst_begins;
+                        if (first > last)
+                            append_zone_transition(zone, first, begins_first ? rule.dst_offset : rule.std_offset);
+                        if (second > last)
+                            append_zone_transition(zone, second, begins_first ? rule.std_offset : rule.dst_offset);
+                    }
+                    zone.rule_from = ISODateTime::days_from_civil(zone_table_last_year + 1, 1, 1) * 86400;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read a whole file into memory; tzdata files are a few kilobytes.
+ */
+inline bool read_zone_file(const std::string& path, std::vector<unsigned char>& contents)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+    unsigned char chunk[4096];
+    std::size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0 && contents.size() < (1U << 22))
+        contents.insert(contents.end(), chunk, chunk + read);
+    const bool ok = std::ferror(file) == 0 && contents.size() < (1U << 22);
+    std::fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Find a zone in the process-wide cache, loading it from tzdata on first use.
+ *
+ * Names are resolved under $TZDIR (or /usr/share/zoneinfo); absolute paths and ".." are rejected.
+ * "UTC" and "Etc/UTC" are always available, even without tzdata.
+ *
+ * @return The cached zone, or nullptr if it cannot be loaded.
+ */
+inline const time_zone* find_or_load_time_zone(std::string_view name)
+{
+    const std::lock_guard<std::mutex> lock(zones_writer);
+    if (const auto found = zones.find(name); found != zones.end())
+        return found->second.get();
+    if (name.empty() || name.front() == '/' || name.find("..") != std::string_view::npos || name.find('\0') != std::string_view::npos)
+        return nullptr;
+
+    auto zone = std::make_unique<time_zone>();
+    zone->name.assign(name);
+    const char* directory = std::getenv("TZDIR");
+    std::vector<unsigned char> contents;
+    const bool loaded = read_zone_file(std::string(directory != nullptr && *directory != '\0' ? directory : "/usr/share/zoneinfo") + "/" + zone->name, contents)
+                        && parse_tzif(contents.data(), contents.size(), *zone);
+    if (!loaded) {
+        if (name != "UTC" && name != "Etc/UTC")
+            return nullptr;
+        zone->starts.assign(1, std::numeric_limits<std::int64_t>::min());
+        zone->offsets.assign(1, 0);
+        zone->rule_from = std::numeric_limits<std::int64_t>::max();
+    }
+    const time_zone* result = zone.get();
+    zones.emplace(zone->name, std::move(zone));
+    return result;
+}
+
+/**
+ * @brief UTC offset of a zone at a UTC second, without locking or allocating.
+ *
+ * The table entry found last is checked first, so consecutive lookups around the current
+ * time cost two comparisons; a miss binary-searches the table and moves the cached window.
+ */
+inline std::int32_t zone_offset_at(const time_zone& zone, std::int64_t t) noexcept
+{
+    if (t >= zone.rule_from)
+        return posix_rule_offset(zone.rule, t);
+    const auto count = static_cast<std::uint32_t>(zone.starts.size());
+    auto index = zone.last_index.load(std::memory_order_relaxed);
+    if (index < count && zone.starts[index] <= t && (index + 1 == count || t < zone.starts[index + 1])) {
+        isodatetime_detail::count(counter::zone_index_hits);
+        return zone.offsets[index];
+    }
+    isodatetime_detail::count(counter::zone_index_misses);
+    index = static_cast<std::uint32_t>(std::upper_bound(zone.starts.begin(), zone.starts.end(), t) - zone.starts.begin() - 1);
+    zone.last_index.store(index, std::memory_order_relaxed);
+    return zone.offsets[index];
+}
+
+/**
+ * @brief Render a time_point in a zone: the local shape of a layout followed by +HH:MM when it has a time.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is not renderable.
+ */
+inline std::size_t write_zoned_text(char* buffer, std::size_t size, const time_zone& zone, const format_layout& layout,
+                                    const std::chrono::time_point<std::chrono::system_clock>& time_point) noexcept
+{
+    // Check the whole text, suffix included, before writing any of it
+    const std::size_t body = layout.with_time ? 19 + (layout.fraction_digits == 0 ? 0 : layout.fraction_digits + 1) : 10;
+    if (buffer == nullptr || size < body + (layout.with_time ? 6 : 0))
+        return 0;
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = static_cast<std::int64_t>(split_time_point(time_point, nanoseconds));
+    const std::int32_t offset = zone_offset_at(zone, seconds);
+    const std::size_t length = write_iso_text(buffer, size, to_utc_tm(static_cast<std::time_t>(seconds + offset)), layout.with_time, layout.fraction_digits, nanoseconds, false);
+    if (length == 0 || !layout.with_time)
+        return length;
+    write_utc_offset(buffer + length, offset);
+    return length + 6;
+}
+
+// ---------- Parsing ----------
+
+/**
+ * @brief Calendar and clock fields read from ISO 8601 text.
+ */
+struct parsed_fields {
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+    unsigned hour;
+    unsigned minute;
+    unsigned second;
+    std::uint32_t nanoseconds;
+    bool zulu;
+    bool has_offset; // explicit +HH:MM / -HH:MM suffix
+    std::int32_t offset; // seconds east of UTC when has_offset
+};
+
+/**
+ * @brief Read a fixed number of ASCII digits.
+ * @param text Start of the digits.
+ * @param count Number of digits to read.
+ * @param value Receives the decimal value.
+ * @return true if all count characters are digits.
+ */
+inline bool read_digits(const char* text, unsigned count, unsigned& value) noexcept
+{
+    unsigned result = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        const auto digit = static_cast<unsigned>(static_cast<unsigned char>(text[i])) - '0';
+        if (digit > 9)
+            return false;
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
+/**
+ * @brief Number of days in a month of the proleptic Gregorian calendar.
+ */
+constexpr unsigned days_in_month(std::int64_t year, unsigned month) noexcept
+{
+    constexpr unsigned char days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+/**
+ * @brief Validate the calendar and clock ranges of parsed fields.
+ */
+inline bool fields_in_range(const parsed_fields& fields) noexcept
+{
+    return fields.month >= 1 && fields.month <= 12
+        && fields.day >= 1 && fields.day <= days_in_month(fields.year, fields.month)
+        && fields.hour < 24 && fields.minute < 60 && fields.second < 60;
+}
+
+/**
+ * @brief Parse one of the fixed-width shapes this class emits.
+ *
+ * Accepted: YYYY-MM-DD, YYYY-MM-DDTHH:MM:SS, and YYYY-MM-DDTHH:MM:SS followed by a '.' and
+ * 3, 6 or 9 fraction digits; any of them optionally followed by 'Z', and the shapes with a
+ * time optionally followed by a +HH:MM or -HH:MM offset instead. Every character is checked
+ * at its fixed position; there is no locale and no allocation.
+ *
+ * @param text Text to parse.
+ * @param fields Receives the parsed fields.
+ * @return true if text has one of the accepted shapes and all fields are in range.
+ */
+inline bool parse_fields(std::string_view text, parsed_fields& fields) noexcept
+{
+    fields = parsed_fields{};
+    fields.zulu = !text.empty() && text.back() == 'Z';
+    if (!fields.zulu && text.size() >= 25 && (text[text.size() - 6] == '+' || text[text.size() - 6] == '-') && text[text.size() - 3] == ':') {
+        const char* suffix = text.data() + text.size() - 6;
+        unsigned hours = 0, minutes = 0;
+        if (!read_digits(suffix + 1, 2, hours) || !read_digits(suffix + 4, 2, minutes) || hours > 23 || minutes > 59)
+            return false;
+        const auto magnitude = static_cast<std::int32_t>(hours * 3600 + minutes * 60);
+        fields.has_offset = true;
+        fields.offset = suffix[0] == '-' ? -magnitude : magnitude;
+        text.remove_suffix(6);
+    }
+    const std::size_t length = text.size() - (fields.zulu ? 1 : 0);
+    if (length != 10 && length != 19 && length != 23 && length != 26 && length != 29)
+        return false;
+
+    const char* p = text.data();
+    unsigned year = 0;
+    if (!read_digits(p, 4, year) || p[4] != '-' || !read_digits(p + 5, 2, fields.month)
+        || p[7] != '-' || !read_digits(p + 8, 2, fields.day))
+        return false;
+    fields.year = year;
+    if (length > 10) {
+        if (p[10] != 'T' || !read_digits(p + 11, 2, fields.hour) || p[13] != ':'
+            || !read_digits(p + 14, 2, fields.minute) || p[16] != ':' || !read_digits(p + 17, 2, fields.second))
+            return false;
+    }
+    if (length > 19) {
+        const auto fraction_digits = static_cast<unsigned>(length - 20);
+        unsigned fraction = 0;
+        if (p[19] != '.' || !read_digits(p + 20, fraction_digits, fraction))
+            return false;
+        constexpr std::uint32_t scale[] = {1000000, 1000, 1};
+        fields.nanoseconds = fraction * scale[fraction_digits / 3 - 1];
+    }
+    return fields_in_range(fields);
+}
+
+/**
+ * @brief Seconds since the epoch of the civil date and time in fields, read as UTC.
+ */
+inline std::int64_t fields_to_seconds(const parsed_fields& fields) noexcept
+{
+    return ISODateTime::days_from_civil(fields.year, fields.month, fields.day) * 86400
+           + fields.hour * 3600 + fields.minute * 60 + fields.second;
+}
+
+/**
+ * @brief Convert a local wall-clock time, expressed as seconds since the local epoch, to UTC seconds.
+ *
+ * Uses the local offset cache when it covers the time, otherwise std::mktime with DST
+ * determined by the C library. Wall-clock times that occur twice in a DST fall-back resolve to
+ * one of the two instants.
+ *
+ * @param local_seconds Local date and time, encoded as if it were UTC.
+ * @return The UTC second, or std::nullopt if the C library cannot represent it.
+ */
+inline std::optional<std::int64_t> local_seconds_to_utc(std::int64_t local_seconds)
+{
+    int is_dst = 0;
+    if (const auto guess = lookup_local_offset(local_seconds, is_dst)) {
+        if (const auto offset = lookup_local_offset(local_seconds - *guess, is_dst))
+            return local_seconds - *offset;
+    }
+    auto tm = to_utc_tm(static_cast<std::time_t>(local_seconds));
+    tm.tm_isdst = -1;
+    const auto t = std::mktime(&tm);
+    if (t == static_cast<std::time_t>(-1))
+        return std::nullopt;
+    return static_cast<std::int64_t>(t);
+}
+
+/**
+ * @brief Build a system_clock time_point from a UTC second and a nanosecond fraction.
+ * @return The time_point, or std::nullopt if it is outside the range of system_clock::duration
+ *         (about 1677-2262 where the clock counts nanoseconds).
+ */
+inline std::optional<std::chrono::time_point<std::chrono::system_clock>> make_time_point(std::int64_t seconds, std::uint32_t nanoseconds) noexcept
+{
+    using duration = std::chrono::system_clock::duration;
+    constexpr auto lowest = std::chrono::duration_cast<std::chrono::seconds>(duration::min()).count();
+    constexpr auto highest = std::chrono::duration_cast<std::chrono::seconds>(duration::max()).count();
+    if (seconds < lowest || seconds > highest)
+        return std::nullopt;
+    const auto whole = std::chrono::duration_cast<duration>(std::chrono::seconds(seconds));
+    const auto fraction = std::chrono::duration_cast<duration>(std::chrono::nanoseconds(nanoseconds));
+    if (whole.count() > duration::max().count() - fraction.count())
+        return std::nullopt;
+    return std::chrono::time_point<std::chrono::system_clock>(whole + fraction);
+}
+
+// ---------- Batch parsing ----------
+
+/**
+ * @brief Signature of a kernel reading the 23-character body "YYYY-MM-DDTHH:MM:SS.mmm".
+ *
+ * Kernels check digits and separators and fill the fields; range checks are left to the caller.
+ */
+using timestamp_body_kernel = bool (*)(const char*, parsed_fields&) noexcept;
+
+/**
+ * @brief Portable kernel for a timestamp body.
+ */
+inline bool read_timestamp_body_scalar(const char* text, parsed_fields& fields) noexcept
+{
+    unsigned year = 0;
+    unsigned milliseconds = 0;
+    if (!read_digits(text, 4, year) || text[4] != '-' || !read_digits(text + 5, 2, fields.month)
+        || text[7] != '-' || !read_digits(text + 8, 2, fields.day) || text[10] != 'T'
+        || !read_digits(text + 11, 2, fields.hour) || text[13] != ':' || !read_digits(text + 14, 2, fields.minute)
+        || text[16] != ':' || !read_digits(text + 17, 2, fields.second) || text[19] != '.'
+        || !read_digits(text + 20, 3, milliseconds))
+        return false;
+    fields.year = year;
+    fields.nanoseconds = milliseconds * 1000000;
+    return true;
+}
+
+#if defined(ISODATETIME_X86)
+/**
+ * @brief SSSE3 kernel for a timestamp body.
+ *
+ * Two overlapping 16-byte loads (bytes 0-15 and 7-22) are validated against a separator
+ * template in one pass, then pshufb gathers the digit pairs and pmaddubsw folds each pair
+ * into its two-digit value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("ssse3")))
+#endif
+inline bool read_timestamp_body_ssse3(const char* text, parsed_fields& fields) noexcept
+{
+    const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 7));
+
+    // Expected separators, and masks of the digit positions (0xFF = digit)
+    const __m128i head_separators = _mm_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0, 0, 'T', 0, 0, ':', 0, 0);
+    const __m128i head_digits = _mm_setr_epi8(-1, -1, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1);
+    const __m128i tail_separators = _mm_setr_epi8('-', 0, 0, 'T', 0, 0, ':', 0, 0, ':', 0, 0, '.', 0, 0, 0);
+    const __m128i tail_digits = _mm_setr_epi8(0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, -1);
+
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i head_values = _mm_sub_epi8(head, zero);
+    const __m128i tail_values = _mm_sub_epi8(tail, zero);
+    const auto valid = [](__m128i bytes, __m128i values, __m128i separators, __m128i digits) {
+        // Digit positions: unsigned value <= 9 (min(value, 9) == value); others: exact separator
+        const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+        const __m128i is_separator = _mm_cmpeq_epi8(bytes, separators);
+        return _mm_or_si128(_mm_and_si128(digits, is_digit), _mm_andnot_si128(digits, is_separator));
+    };
+    const __m128i ok = _mm_and_si128(valid(head, head_values, head_separators, head_digits),
+                                     valid(tail, tail_values, tail_separators, tail_digits));
+    if (_mm_movemask_epi8(ok) != 0xFFFF)
+        return false;
+
+    // Pairs: YY YY MM DD hh mm from head, ss and the first two millisecond digits from tail
+    const __m128i pairs = _mm_or_si128(
+        _mm_shuffle_epi8(head_values, _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(tail_values, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 10, 11, 13, 14)));
+    alignas(16) std::uint16_t values[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(values), _mm_maddubs_epi16(pairs, _mm_set1_epi16(0x010A)));
+
+    fields.year = values[0] * 100 + values[1];
+    fields.month = values[2];
+    fields.day = values[3];
+    fields.hour = values[4];
+    fields.minute = values[5];
+    fields.second = values[6];
+    fields.nanoseconds = (values[7] * 10U + static_cast<unsigned>(text[22] - '0')) * 1000000U;
+    return true;
+}
+
+/**
+ * @brief Whether the running CPU supports SSSE3.
+ */
+inline bool cpu_has_ssse3() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuid(registers, 1);
+    return (registers[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+#if defined(ISODATETIME_NEON)
+/**
+ * @brief NEON kernel for a timestamp body; same layout as the SSSE3 kernel.
+ */
+inline bool read_timestamp_body_neon(const char* text, parsed_fields& fields) noexcept
+{
+    const uint8x16_t head = vld1q_u8(reinterpret_cast<const std::uint8_t*>(text));
+    const uint8x16_t tail = vld1q_u8(reinterpret_cast<const std::uint8_t*>(text + 7));
+
+    static const std::uint8_t head_separators[16] = {0, 0, 0, 0, '-', 0, 0, '-', 0, 0, 'T', 0, 0, ':', 0, 0};
+    static const std::uint8_t head_digits[16] = {255, 255, 255, 255, 0, 255, 255, 0, 255, 255, 0, 255, 255, 0, 255, 255};
+    static const std::uint8_t tail_separators[16] = {'-', 0, 0, 'T', 0, 0, ':', 0, 0, ':', 0, 0, '.', 0, 0, 0};
+    static const std::uint8_t tail_digits[16] = {0, 255, 255, 0, 255, 255, 0, 255, 255, 0, 255, 255, 0, 255, 255, 255};
+    static const std::uint8_t head_pairs[16] = {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 255, 255, 255, 255};
+    static const std::uint8_t tail_pairs[16] = {255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 10, 11, 13, 14};
+
+    const uint8x16_t head_values = vsubq_u8(head, vdupq_n_u8('0'));
+    const uint8x16_t tail_values = vsubq_u8(tail, vdupq_n_u8('0'));
+    const auto valid = [](uint8x16_t bytes, uint8x16_t values, const std::uint8_t* separators, const std::uint8_t* digits) {
+        return vbslq_u8(vld1q_u8(digits), vcleq_u8(values, vdupq_n_u8(9)), vceqq_u8(bytes, vld1q_u8(separators)));
+    };
+    const uint8x16_t ok = vandq_u8(valid(head, head_values, head_separators, head_digits),
+                                   valid(tail, tail_values, tail_separators, tail_digits));
+    if (vminvq_u8(ok) != 0xFF)
+        return false;
+
+    // Out-of-range table indices yield 0, so the two gathers can simply be OR-ed
+    const uint16x8_t pairs = vreinterpretq_u16_u8(vorrq_u8(vqtbl1q_u8(head_values, vld1q_u8(head_pairs)),
+                                                           vqtbl1q_u8(tail_values, vld1q_u8(tail_pairs))));
+    // Each 16-bit lane holds (low digit << 8) | high digit
+    std::uint16_t values[8];
+    vst1q_u16(values, vmlaq_n_u16(vshrq_n_u16(pairs, 8), vandq_u16(pairs, vdupq_n_u16(0xFF)), 10));
+
+    fields.year = values[0] * 100 + values[1];
+    fields.month = values[2];
+    fields.day = values[3];
+    fields.hour = values[4];
+    fields.minute = values[5];
+    fields.second = values[6];
+    fields.nanoseconds = (values[7] * 10U + static_cast<unsigned>(text[22] - '0')) * 1000000U;
+    return true;
+}
+#endif
+
+/**
+ * @brief Pick the fastest timestamp body kernel for the running CPU, once per process.
+ */
+inline timestamp_body_kernel get_timestamp_body_kernel() noexcept
+{
+    static const timestamp_body_kernel kernel = [] {
+#if defined(ISODATETIME_X86)
+        if (cpu_has_ssse3())
+            return &read_timestamp_body_ssse3;
+#elif defined(ISODATETIME_NEON)
+        return &read_timestamp_body_neon;
+#endif
+        return &read_timestamp_body_scalar;
+    }();
+    return kernel;
+}
+
+// ---------- Sortable keys ----------
+
+/**
+ * @brief Load 8 bytes as a little-endian word.
+ */
+inline std::uint64_t load_word(const char* text) noexcept
+{
+    std::uint64_t word = 0;
+    std::memcpy(&word, text, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/**
+ * @brief Check 8 bytes against a template of digits ('0') and exact separators.
+ *
+ * Digit bytes must be 0x30-0x39: their high nibble is 3 before and after adding 6. Carries
+ * between bytes can only come from bytes that already failed the check.
+ *
+ * @param word Eight text bytes, little-endian.
+ * @param expected The template, little-endian.
+ * @param digits 0xFF at the digit positions of the template.
+ * @param ok Cleared if the bytes do not match the template.
+ * @return The digit values, one per byte (0 at separators).
+ */
+inline std::uint64_t match_digit_template(std::uint64_t word, std::uint64_t expected, std::uint64_t digits, bool& ok) noexcept
+{
+    const std::uint64_t mask = ~digits | (digits & 0xF0F0F0F0F0F0F0F0ULL);
+    const std::uint64_t plus_six = digits & 0x0606060606060606ULL;
+    ok &= (word & mask) == expected && ((word + plus_six) & mask) == expected;
+    return word - expected;
+}
+
+/**
+ * @brief Byte j of the result is the two-digit value of digit bytes j and j + 1 (read only where j starts a pair).
+ */
+constexpr std::uint64_t fold_digit_pairs(std::uint64_t values) noexcept
+{
+    return values * 10 + (values >> 8);
+}
+
+/**
+ * @brief Byte j of a word.
+ */
+constexpr unsigned word_byte(std::uint64_t word, unsigned j) noexcept
+{
+    return static_cast<unsigned>(word >> (8 * j)) & 0xFF;
+}
+
+/**
+ * @brief Key of one record, or 0 if it is malformed or out of range.
+ *
+ * The key packs year:14 month:4 day:5 hour:5 minute:6 second:6 microsecond:20 from bit 59 down,
+ * so it orders like the time and is a plain shift away from day or hour buckets. The first 23
+ * body characters are validated and converted as three overlapping 8-byte words without a
+ * branch per character; bodies shorter than that are laid over "0000-00-00T00:00:00.000"
+ * first. Microsecond digits are read separately and nanosecond digits only checked.
+ *
+ * @param text Start of the record.
+ * @param length Length of the record.
+ */
+inline std::uint64_t read_sortable_key(const char* text, std::size_t length) noexcept
+{
+    // Shape from the suffix, as in parse_fields: 29 characters is a nanosecond body or a millisecond body with an offset
+    const bool zulu = length > 0 && text[length - 1] == 'Z';
+    const bool with_offset = !zulu && length >= 25 && (text[length - 6] == '+' || text[length - 6] == '-') && text[length - 3] == ':';
+    const std::size_t body = length - (zulu ? 1 : 0) - (with_offset ? 6 : 0);
+    if (body != 10 && body != 19 && body != 23 && body != 26 && body != 29)
+        return 0;
+
+    char padded[24] = "0000-00-00T00:00:00.000";
+    const char* p = text;
+    if (body < 23) {
+        std::memcpy(padded, text, 10);
+        if (body == 19)
+            std::memcpy(padded + 10, text + 10, 9);
+        p = padded;
+    }
+
+    // Bytes 0-7 "YYYY-MM-", 8-15 "DDTHH:MM" and 15-22 "M:SS.mmm"
+    bool ok = true;
+    const std::uint64_t head = fold_digit_pairs(match_digit_template(load_word(p), 0x2D30302D30303030ULL, 0x00FFFF00FFFFFFFFULL, ok));
+    const std::uint64_t middle = fold_digit_pairs(match_digit_template(load_word(p + 8), 0x30303A3030543030ULL, 0xFFFF00FFFF00FFFFULL, ok));
+    const std::uint64_t tail_values = match_digit_template(load_word(p + 15), 0x3030302E30303A30ULL, 0xFFFFFF00FFFF00FFULL, ok);
+    const std::uint64_t tail = fold_digit_pairs(tail_values);
+
+    parsed_fields fields{};
+    fields.year = word_byte(head, 0) * 100 + word_byte(head, 2);
+    fields.month = word_byte(head, 5);
+    fields.day = word_byte(middle, 0);
+    fields.hour = word_byte(middle, 3);
+    fields.minute = word_byte(middle, 6);
+    fields.second = word_byte(tail, 2);
+    const unsigned milliseconds = word_byte(tail, 5) * 10 + word_byte(tail_values, 7);
+    unsigned microseconds = 0;
+    unsigned nanoseconds = 0;
+    if (body >= 26)
+        ok &= read_digits(text + 23, 3, microseconds);
+    if (body == 29)
+        ok &= read_digits(text + 26, 3, nanoseconds);
+    // As fields_in_range, with the month length only worked out for days past the 28th
+    ok &= fields.month - 1 < 12 && fields.day != 0 && (fields.day <= 28 || fields.day <= days_in_month(fields.year, fields.month))
+          && fields.hour < 24 && fields.minute < 60 && fields.second < 60;
+
+    if (with_offset && ok) {
+        const char* suffix = text + body;
+        unsigned hours = 0, minutes = 0;
+        ok &= read_digits(suffix + 1, 2, hours) && read_digits(suffix + 4, 2, minutes) && hours <= 23 && minutes <= 59;
+        const auto offset = static_cast<std::int32_t>(hours * 3600 + minutes * 60);
+        // Only offset text pays for the calendar: move the fields to UTC
+        const std::int64_t seconds = fields_to_seconds(fields) - (suffix[0] == '-' ? -offset : offset);
+        const std::int64_t days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+        const auto date = ISODateTime::civil_from_days(days);
+        const auto time_of_day = static_cast<unsigned>(seconds - days * 86400);
+        ok &= date.year >= 0 && date.year <= 9999;
+        fields.year = date.year;
+        fields.month = date.month;
+        fields.day = date.day;
+        fields.hour = time_of_day / 3600;
+        fields.minute = time_of_day / 60 % 60;
+        fields.second = time_of_day % 60;
+    }
+    if (!ok)
+        return 0;
+    return static_cast<std::uint64_t>(fields.year) << 46 | std::uint64_t{fields.month} << 42 | std::uint64_t{fields.day} << 37
+           | std::uint64_t{fields.hour} << 32 | std::uint64_t{fields.minute} << 26 | std::uint64_t{fields.second} << 20
+           | (milliseconds * 1000 + microseconds);
+}
+
+// ---------- Log rewriting ----------
+
+/**
+ * @brief Length of the timestamp starting at p: "YYYY-MM-DDTHH:MM:SS", an optional '.' with 3, 6
+ *        or 9 digits, then an optional 'Z' or +HH:MM / -HH:MM.
+ *
+ * Only digits and separators are checked here; parse_fields validates the ranges. Text that
+ * merely has a 'T' in the right place, such as "INFO TestRunner", does not match, so the scan
+ * goes on to the timestamp later in the line.
+ *
+ * @param p Candidate first character of the year.
+ * @param end End of the line.
+ * @return Token length, or 0 if the shape does not match or runs into more digits.
+ */
+inline std::size_t match_log_timestamp(const char* p, const char* end) noexcept
+{
+    const auto available = static_cast<std::size_t>(end - p);
+    unsigned value = 0;
+    if (available < 19 || p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' || p[16] != ':'
+        || !read_digits(p, 4, value) || !read_digits(p + 5, 2, value) || !read_digits(p + 8, 2, value)
+        || !read_digits(p + 11, 2, value) || !read_digits(p + 14, 2, value) || !read_digits(p + 17, 2, value))
+        return 0;
+    std::size_t length = 19;
+    if (length < available && p[length] == '.') {
+        std::size_t digits = 0;
+        while (length + 1 + digits < available && digits < 10 && static_cast<unsigned>(static_cast<unsigned char>(p[length + 1 + digits])) - '0' <= 9)
+            ++digits;
+        if (digits == 3 || digits == 6 || digits == 9)
+            length += 1 + digits;
+        else if (digits != 0)
+            return 0;
+    }
+    if (length < available && p[length] == 'Z')
+        ++length;
+    else if (available - length >= 6 && (p[length] == '+' || p[length] == '-') && p[length + 3] == ':')
+        length += 6;
+    if (length < available && static_cast<unsigned>(static_cast<unsigned char>(p[length])) - '0' <= 9)
+        return 0;
+    return length;
+}
+
+/**
+ * @brief One newline-aligned slice of the input and its rewritten text.
+ */
+struct log_chunk {
+    const char* begin{};
+    const char* end{};
+    std::unique_ptr<char[]> output; // reused across waves; grows only
+    std::size_t capacity{};
+    std::size_t length{};
+    std::uint64_t lines{};
+    std::uint64_t converted{};
+};
+
+/**
+ * @brief Rewrite the first local or offset timestamp of every line of a chunk as UTC 'Z' text.
+ *
+ * Lines without a timestamp, and timestamps that are already UTC or cannot be converted, are
+ * copied unchanged. Local times are resolved once per distinct local second, so only the first
+ * line of each second pays for local_seconds_to_utc.
+ *
+ * @param chunk Chunk to rewrite; output, length, lines and converted are filled in.
+ * @param column Byte offset of the timestamp in every line, or ISODateTime::scan_for_timestamp.
+ */
+inline void rewrite_log_chunk(log_chunk& chunk, std::size_t column)
+{
+    // A converted timestamp is at least 19 bytes and grows by at most one (the 'Z')
+    const auto input_length = static_cast<std::size_t>(chunk.end - chunk.begin);
+    const std::size_t bound = input_length + input_length / 19 + 1;
+    if (chunk.capacity < bound) {
+        chunk.output.reset(new char[bound]);
+        chunk.capacity = bound;
+    }
+    char* out = chunk.output.get();
+    chunk.lines = 0;
+    chunk.converted = 0;
+
+    std::int64_t memo_local = std::numeric_limits<std::int64_t>::min();
+    std::optional<std::int64_t> memo_utc;
+    const char* line = chunk.begin;
+    while (line < chunk.end) {
+        const auto* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(chunk.end - line)));
+        const char* line_end = newline != nullptr ? newline : chunk.end;
+        const char* next = newline != nullptr ? newline + 1 : chunk.end;
+        ++chunk.lines;
+
+        const char* token = nullptr;
+        std::size_t token_length = 0;
+        if (column != ISODateTime::scan_for_timestamp) {
+            if (column < static_cast<std::size_t>(line_end - line)) {
+                token = line + column;
+                token_length = match_log_timestamp(token, line_end);
+            }
+        } else {
+            const char* search = line + std::min<std::size_t>(10, static_cast<std::size_t>(line_end - line));
+            while (token_length == 0 && search < line_end) {
+                const auto* t = static_cast<const char*>(std::memchr(search, 'T', static_cast<std::size_t>(line_end - search)));
+                if (t == nullptr)
+                    break;
+                token = t - 10;
+                token_length = match_log_timestamp(token, line_end);
+                search = t + 1;
+            }
+        }
+
+        parsed_fields fields{};
+        std::optional<std::int64_t> utc;
+        if (token_length != 0 && parse_fields(std::string_view(token, token_length), fields) && !fields.zulu) {
+            const std::int64_t seconds = fields_to_seconds(fields);
+            if (fields.has_offset) {
+                utc = seconds - fields.offset;
+            } else {
+                if (seconds != memo_local) {
+                    memo_utc = local_seconds_to_utc(seconds);
+                    memo_local = seconds;
+                }
+                utc = memo_utc;
+            }
+        }
+
+        std::size_t written = 0;
+        if (utc) {
+            const std::size_t body_length = token_length - (fields.has_offset ? 6 : 0);
+            const auto fraction_digits = static_cast<unsigned>(body_length > 19 ? body_length - 20 : 0);
+            const auto before = static_cast<std::size_t>(token - line);
+            std::memcpy(out, line, before);
+            written = write_from_cache(out + before, fraction_digits + 21, get_cached_second(static_cast<std::time_t>(*utc), true), true,
+                                       fraction_digits, fields.nanoseconds, true);
+            if (written != 0) {
+                out += before + written;
+                const auto after = static_cast<std::size_t>(next - (token + token_length));
+                std::memcpy(out, token + token_length, after);
+                out += after;
+                ++chunk.converted;
+            }
+        }
+        if (written == 0) {
+            std::memcpy(out, line, static_cast<std::size_t>(next - line));
+            out += next - line;
+        }
+        line = next;
+    }
+    chunk.length = static_cast<std::size_t>(out - chunk.output.get());
+}
+
+/**
+ * @brief Read-only view of a whole input file: memory-mapped where possible, otherwise read into memory.
+ */
+class mapped_input {
+public:
+    explicit mapped_input(const std::string& path)
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat status{};
+        if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+            device_ = static_cast<std::uint64_t>(status.st_dev);
+            inode_ = static_cast<std::uint64_t>(status.st_ino);
+            size_ = static_cast<std::size_t>(status.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else if (void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0); mapping != MAP_FAILED) {
+                ::madvise(mapping, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(mapping);
+                mapped_ = true;
+                ok_ = true;
+            }
+        }
+        ::close(fd);
+        if (ok_)
+            return;
+        size_ = 0;
+#endif
+        read_whole_file(path);
+    }
+
+    ~mapped_input()
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        if (mapped_)
+            ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    mapped_input(const mapped_input&) = delete;
+    mapped_input& operator=(const mapped_input&) = delete;
+
+    bool ok() const noexcept { return ok_; }
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Whether path names this same file (so writing it would clobber the input).
+     */
+    bool same_file(const std::string& path) const noexcept
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        struct stat status{};
+        return mapped_ && ::stat(path.c_str(), &status) == 0 && static_cast<std::uint64_t>(status.st_dev) == device_
+               && static_cast<std::uint64_t>(status.st_ino) == inode_;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+private:
+    void read_whole_file(const std::string& path)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return;
+        char chunk[1 << 16];
+        std::size_t read = 0;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            contents_.insert(contents_.end(), chunk, chunk + read);
+        ok_ = std::ferror(file) == 0;
+        std::fclose(file);
+        data_ = contents_.data();
+        size_ = contents_.size();
+    }
+
+    const char* data_{};
+    std::size_t size_{};
+    bool ok_{false};
+    bool mapped_{false};
+    std::uint64_t device_{};
+    std::uint64_t inode_{};
+    std::vector<char> contents_; // read fallback
+};
+
+/**
+ * @brief Split input into chunks of at least chunk_size bytes, each ending just after a newline (or at the end).
+ */
+inline std::vector<log_chunk> split_log_chunks(const char* data, std::size_t size, std::size_t chunk_size)
+{
+    std::vector<log_chunk> chunks;
+    std::size_t begin = 0;
+    while (begin < size) {
+        std::size_t end = size;
+        if (size - begin > chunk_size) {
+            const auto* newline = static_cast<const char*>(std::memchr(data + begin + chunk_size, '\n', size - begin - chunk_size));
+            if (newline != nullptr)
+                end = static_cast<std::size_t>(newline - data) + 1;
+        }
+        log_chunk chunk;
+        chunk.begin = data + begin;
+        chunk.end = data + end;
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+    return chunks;
+}
+
+} // namespace isodatetime_detail
+
+// ---------- Public functions ----------
+
+/**
+ * @brief Get the ISO 8601 formatted date (YYYY-MM-DD) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_length];
+    return {buffer, format_current_iso_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date and time (YYYY-MM-DDTHH:MM:SS) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 date-time string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_time(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_time_length];
+    return {buffer, format_current_iso_date_time(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with milliseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_timestamp_length];
+    return {buffer, format_current_iso_date_timestamp(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date (YYYY-MM-DD) for the current system time.
+ * @return ISO 8601 date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date()
+{
+    return get_current_iso_date(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date and time (YYYY-MM-DDTHH:MM:SS) for the current system time.
+ * @return ISO 8601 date-time string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_time()
+{
+    return get_current_iso_date_time(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        for the current system time.
+ *        Returns the ticker's latest text when start_ticker was asked to serve it.
+ * @return ISO 8601 timestamp string with milliseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp()
+{
+    if (isodatetime_detail::ticker_serves_current.load(std::memory_order_relaxed))
+        return get_ticker_iso_date_timestamp().str();
+    return get_current_iso_date_timestamp(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date (YYYY-MM-DD) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[utc_iso_date_length];
+    return {buffer, format_current_utc_iso_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date and time (YYYY-MM-DDTHH:MM:SS) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 date-time string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_time(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[utc_iso_date_time_length];
+    return {buffer, format_current_utc_iso_date_time(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with milliseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[utc_iso_date_timestamp_length];
+    return {buffer, format_current_utc_iso_date_timestamp(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date (YYYY-MM-DD) for the current system time.
+ * @return ISO 8601 date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date()
+{
+    return get_current_utc_iso_date(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date and time (YYYY-MM-DDTHH:MM:SS) for the current system time.
+ * @return ISO 8601 date-time string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_time()
+{
+    return get_current_utc_iso_date_time(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        for the current system time.
+ *        Returns the ticker's latest text when start_ticker was asked to serve it.
+ * @return ISO 8601 timestamp string with milliseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp()
+{
+    if (isodatetime_detail::ticker_serves_current.load(std::memory_order_relaxed))
+        return get_ticker_utc_iso_date_timestamp().str();
+    return get_current_utc_iso_date_timestamp(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffff)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with microseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_us(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_timestamp_us_length];
+    return {buffer, format_current_iso_date_timestamp_us(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffff)
+ *        for the current system time.
+ * @return ISO 8601 timestamp string with microseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_us()
+{
+    return get_current_iso_date_timestamp_us(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffff)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with nanoseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_ns(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_timestamp_ns_length];
+    return {buffer, format_current_iso_date_timestamp_ns(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffff)
+ *        for the current system time.
+ * @return ISO 8601 timestamp string with nanoseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_ns()
+{
+    return get_current_iso_date_timestamp_ns(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffffZ)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with microseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp_us(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[utc_iso_date_timestamp_us_length];
+    return {buffer, format_current_utc_iso_date_timestamp_us(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffffZ)
+ *        for the current system time.
+ * @return ISO 8601 timestamp string with microseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp_us()
+{
+    return get_current_utc_iso_date_timestamp_us(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffffZ)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with nanoseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp_ns(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[utc_iso_date_timestamp_ns_length];
+    return {buffer, format_current_utc_iso_date_timestamp_ns(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted UTC date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffffZ)
+ *        for the current system time.
+ * @return ISO 8601 timestamp string with nanoseconds precision.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_date_timestamp_ns()
+{
+    return get_current_utc_iso_date_timestamp_ns(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted local date and time with UTC offset (YYYY-MM-DDTHH:MM:SS+HH:MM)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 date-time string with UTC offset.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_time_offset(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_time_offset_length];
+    return {buffer, format_current_iso_date_time_offset(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted local date, time, and milliseconds with UTC offset (YYYY-MM-DDTHH:MM:SS.mmm+HH:MM)
+ *        from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 timestamp string with milliseconds precision and UTC offset.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_offset(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_date_timestamp_offset_length];
+    return {buffer, format_current_iso_date_timestamp_offset(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 formatted local date and time with UTC offset (YYYY-MM-DDTHH:MM:SS+HH:MM) for the current system time.
+ * @return ISO 8601 date-time string with UTC offset.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_time_offset()
+{
+    return get_current_iso_date_time_offset(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 formatted local date, time, and milliseconds with UTC offset (YYYY-MM-DDTHH:MM:SS.mmm+HH:MM)
+ *        for the current system time.
+ * @return ISO 8601 timestamp string with milliseconds precision and UTC offset.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_date_timestamp_offset()
+{
+    return get_current_iso_date_timestamp_offset(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 week date (YYYY-Www-D) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 week date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_week_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_week_date_length];
+    return {buffer, format_current_iso_week_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 week date (YYYY-Www-D) for the current system time.
+ * @return ISO 8601 week date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_week_date()
+{
+    return get_current_iso_week_date(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 ordinal date (YYYY-DDD) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 ordinal date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_ordinal_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_ordinal_date_length];
+    return {buffer, format_current_iso_ordinal_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 ordinal date (YYYY-DDD) for the current system time.
+ * @return ISO 8601 ordinal date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_iso_ordinal_date()
+{
+    return get_current_iso_ordinal_date(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 UTC week date (YYYY-Www-D) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 week date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_week_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_week_date_length];
+    return {buffer, format_current_utc_iso_week_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 UTC week date (YYYY-Www-D) for the current system time.
+ * @return ISO 8601 week date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_week_date()
+{
+    return get_current_utc_iso_week_date(std::nullopt);
+}
+
+/**
+ * @brief Get the ISO 8601 UTC ordinal date (YYYY-DDD) from a given time_point or from the current system time.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return ISO 8601 ordinal date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_ordinal_date(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point)
+{
+    char buffer[iso_ordinal_date_length];
+    return {buffer, format_current_utc_iso_ordinal_date(buffer, sizeof(buffer), time_point)};
+}
+
+/**
+ * @brief Get the ISO 8601 UTC ordinal date (YYYY-DDD) for the current system time.
+ * @return ISO 8601 ordinal date string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_current_utc_iso_ordinal_date()
+{
+    return get_current_utc_iso_ordinal_date(std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date (YYYY-MM-DD) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from a process-wide cache of the current day that is rebuilt only when a day boundary is crossed.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, false, !time_point);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date and time (YYYY-MM-DDTHH:MM:SS) into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_time_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_time(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_time);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 0, nanoseconds, false);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_timestamp);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 3, nanoseconds, false);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date (YYYY-MM-DD) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date and time (YYYY-MM-DDTHH:MM:SS) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_time_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_time(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date_time(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm)
+ *        for the current system time into a caller-supplied buffer.
+ *        Returns the ticker's latest text when start_ticker was asked to serve it.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp(char* buffer, std::size_t size) noexcept
+{
+    if (isodatetime_detail::ticker_serves_current.load(std::memory_order_relaxed))
+        return isodatetime_detail::copy_ticker_text<iso_date_timestamp_length>(buffer, size, isodatetime_detail::load_ticker_slot().local);
+    return format_current_iso_date_timestamp(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date (YYYY-MM-DD) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from a process-wide cache of the current day that is rebuilt only when a day boundary is crossed.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::utc_iso_date);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, true, !time_point);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date and time (YYYY-MM-DDTHH:MM:SSZ) into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_time_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_time(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::utc_iso_date_time);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, true), true, 0, nanoseconds, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmmZ)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::utc_iso_date_timestamp);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, true), true, 3, nanoseconds, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date (YYYY-MM-DD) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date and time (YYYY-MM-DDTHH:MM:SSZ) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_time_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_time(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_date_time(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmmZ)
+ *        for the current system time into a caller-supplied buffer.
+ *        Returns the ticker's latest text when start_ticker was asked to serve it.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp(char* buffer, std::size_t size) noexcept
+{
+    if (isodatetime_detail::ticker_serves_current.load(std::memory_order_relaxed))
+        return isodatetime_detail::copy_ticker_text<utc_iso_date_timestamp_length>(buffer, size, isodatetime_detail::load_ticker_slot().utc);
+    return format_current_utc_iso_date_timestamp(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffff)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_us_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_us(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_timestamp_us);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 6, nanoseconds, false);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffff)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_us_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_us(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date_timestamp_us(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffff)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_ns_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_ns(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_timestamp_ns);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 9, nanoseconds, false);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffff)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_ns_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_ns(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date_timestamp_ns(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffffZ)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_us_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp_us(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::utc_iso_date_timestamp_us);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, true), true, 6, nanoseconds, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and microseconds (YYYY-MM-DDTHH:MM:SS.ffffffZ)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_us_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp_us(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_date_timestamp_us(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffffZ)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_ns_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp_ns(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::utc_iso_date_timestamp_ns);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, true), true, 9, nanoseconds, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted UTC date, time, and nanoseconds (YYYY-MM-DDTHH:MM:SS.fffffffffZ)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least utc_iso_date_timestamp_ns_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_date_timestamp_ns(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_date_timestamp_ns(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted local date and time with UTC offset (YYYY-MM-DDTHH:MM:SS+HH:MM)
+ *        into a caller-supplied buffer, without heap allocation.
+ *
+ * The offset is that of the local time rendered, so a consumer gets UTC back with an integer
+ * subtraction and no zone lookup.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_time_offset_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_time_offset(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_time_offset);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 0, nanoseconds, false, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted local date, time, and milliseconds with UTC offset (YYYY-MM-DDTHH:MM:SS.mmm+HH:MM)
+ *        into a caller-supplied buffer, without heap allocation.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_offset_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_offset(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count_format(Format::iso_date_timestamp_offset);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, false), true, 3, nanoseconds, false, true);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted local date and time with UTC offset (YYYY-MM-DDTHH:MM:SS+HH:MM)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_time_offset_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_time_offset(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date_time_offset(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 formatted local date, time, and milliseconds with UTC offset (YYYY-MM-DDTHH:MM:SS.mmm+HH:MM)
+ *        for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_date_timestamp_offset_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_date_timestamp_offset(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_date_timestamp_offset(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 week date (YYYY-Www-D) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from the same process-wide cache of the current day as format_current_iso_date. The
+ * week-numbering year is that of the week's Thursday, so it can differ from the calendar year
+ * in the first and last days of January and December.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_week_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is not in 0000-9999.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_week_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::week_date_calls);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, false, !time_point, isodatetime_detail::daily_text::week);
+}
+
+/**
+ * @brief Write the ISO 8601 week date (YYYY-Www-D) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_week_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_week_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_week_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 ordinal date (YYYY-DDD) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from the same process-wide cache of the current day as format_current_iso_date.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_ordinal_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is not in 0000-9999.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_ordinal_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::ordinal_date_calls);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, false, !time_point, isodatetime_detail::daily_text::ordinal);
+}
+
+/**
+ * @brief Write the ISO 8601 ordinal date (YYYY-DDD) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_ordinal_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_iso_ordinal_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_iso_ordinal_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 UTC week date (YYYY-Www-D) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from the same process-wide cache of the current day as format_current_utc_iso_date. The
+ * week-numbering year is that of the week's Thursday, so it can differ from the calendar year
+ * in the first and last days of January and December.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_week_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is not in 0000-9999.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_week_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::week_date_calls);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, true, !time_point, isodatetime_detail::daily_text::week);
+}
+
+/**
+ * @brief Write the ISO 8601 UTC week date (YYYY-Www-D) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_week_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_week_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_week_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Write the ISO 8601 UTC ordinal date (YYYY-DDD) into a caller-supplied buffer, without heap allocation.
+ *
+ * Served from the same process-wide cache of the current day as format_current_utc_iso_date.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_ordinal_date_length bytes.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is not in 0000-9999.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_ordinal_date(char* buffer, std::size_t size, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::ordinal_date_calls);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(get_input_time_point_or_current_system_time(time_point), nanoseconds);
+    return isodatetime_detail::write_daily_date(buffer, size, seconds, true, !time_point, isodatetime_detail::daily_text::ordinal);
+}
+
+/**
+ * @brief Write the ISO 8601 UTC ordinal date (YYYY-DDD) for the current system time into a caller-supplied buffer.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least iso_ordinal_date_length bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_current_utc_iso_ordinal_date(char* buffer, std::size_t size) noexcept
+{
+    return format_current_utc_iso_ordinal_date(buffer, size, std::nullopt);
+}
+
+/**
+ * @brief Switch the local-time functions to the cached UTC offset table.
+ *
+ * The local zone's offset changes around the current time are loaded once and local time is
+ * then computed as UTC plus the cached offset with a lock-free lookup, avoiding localtime_r and
+ * its process-wide tz lock. The table is rebuilt lazily once refresh_interval has elapsed, or
+ * immediately via refresh_local_offset_cache(). Seconds outside the cached window still go
+ * through localtime_r.
+ *
+ * @param refresh_interval How long a loaded table is used before it is rebuilt.
+ */
+ISODATETIME_INLINE void ISODateTime::enable_local_offset_cache(const std::chrono::seconds& refresh_interval)
+{
+    isodatetime_detail::local_offsets_refresh_interval.store(std::chrono::duration_cast<std::chrono::steady_clock::duration>(refresh_interval).count(), std::memory_order_relaxed);
+    refresh_local_offset_cache();
+    isodatetime_detail::local_offsets_enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Switch the local-time functions back to calling localtime_r for every new second.
+ */
+ISODATETIME_INLINE void ISODateTime::disable_local_offset_cache() noexcept
+{
+    isodatetime_detail::local_offsets_enabled.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reload the local zone (tzset), rebuild the cached UTC offset table and drop the cached local date now.
+ *
+ * Call after changing TZ or installing new tzdata. Any thread-local seconds prefix rendered
+ * before the call may be reused for the remainder of its second.
+ */
+ISODATETIME_INLINE void ISODateTime::refresh_local_offset_cache()
+{
+    {
+        const std::lock_guard<std::mutex> lock(isodatetime_detail::local_offsets_writer);
+        isodatetime_detail::rebuild_local_offset_table();
+    }
+    isodatetime_detail::clear_local_daily_date();
+}
+
+/**
+ * @brief Write one time_point in the selected Format into a caller-supplied buffer.
+ * @param format Output format.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least formatted_length(format) bytes.
+ * @param time_point Time to format.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format(Format format, char* buffer, std::size_t size, const std::chrono::time_point<std::chrono::system_clock>& time_point) noexcept
+{
+    isodatetime_detail::count_format(format);
+    const auto layout = isodatetime_detail::get_format_layout(format);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(time_point, nanoseconds);
+    return isodatetime_detail::write_from_cache(buffer, size, isodatetime_detail::get_cached_second(seconds, layout.utc), layout.with_time, layout.fraction_digits, nanoseconds, layout.zulu, layout.offset);
+}
+
+/**
+ * @brief Write many time_points as consecutive fixed-width records in the selected Format.
+ *
+ * Record i occupies [i * formatted_length(format), (i + 1) * formatted_length(format)) of the
+ * buffer. The calendar date is only recomputed when the day changes and the time of day only
+ * when the second changes, so sorted input mostly costs a prefix copy plus the fraction digits.
+ * Local formats take the same route when the local offset cache is enabled and covers the
+ * time; otherwise they convert each new second with localtime.
+ *
+ * @param format Output format.
+ * @param time_points Times to format.
+ * @param count Number of time_points.
+ * @param buffer Destination buffer; no null terminators are written.
+ * @param size Capacity of the destination buffer, at least count * formatted_length(format) bytes.
+ * @return Number of records written: count, fewer if a time_point is not renderable (the records
+ *         up to it are written), or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_batch(Format format, const std::chrono::time_point<std::chrono::system_clock>* time_points, std::size_t count,
+                                      char* buffer, std::size_t size) noexcept
+{
+    const auto layout = isodatetime_detail::get_format_layout(format);
+    const std::size_t length = formatted_length(format);
+    if (time_points == nullptr || buffer == nullptr || count > size / length)
+        return 0;
+    isodatetime_detail::count(isodatetime_detail::counter::batch_records, count);
+
+    const std::size_t prefix_length = layout.with_time ? 19 : 10;
+    char prefix[19];
+    bool have_prefix = false;
+    std::int64_t prefix_second = 0;
+    std::int64_t prefix_day = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        char* out = buffer + i * length;
+        std::uint32_t nanoseconds = 0;
+        const auto seconds = isodatetime_detail::split_time_point(time_points[i], nanoseconds);
+
+        // Wall-clock second to render: UTC as is, local as UTC plus the cached offset
+        std::optional<std::int64_t> wall_second;
+        std::int32_t wall_offset = 0;
+        if (layout.utc) {
+            wall_second = static_cast<std::int64_t>(seconds);
+        } else {
+            int is_dst = 0;
+            if (const auto offset = isodatetime_detail::lookup_local_offset(seconds, is_dst)) {
+                wall_second = static_cast<std::int64_t>(seconds) + *offset;
+                wall_offset = *offset;
+            }
+        }
+
+        if (!wall_second) {
+            // Local time without cache coverage: the per-thread seconds cache does the conversion
+            have_prefix = false;
+            if (isodatetime_detail::write_from_cache(out, length, isodatetime_detail::get_cached_second(seconds, false), layout.with_time, layout.fraction_digits, nanoseconds, false, layout.offset) == 0)
+                return i;
+            continue;
+        }
+
+        const std::int64_t day = (*wall_second >= 0 ? *wall_second : *wall_second - 86399) / 86400;
+        if (!have_prefix || day != prefix_day) {
+            if (isodatetime_detail::write_iso_text(prefix, sizeof(prefix), isodatetime_detail::to_utc_tm(static_cast<std::time_t>(*wall_second)), true, 0, 0, false) == 0)
+                return i;
+            have_prefix = true;
+            prefix_day = day;
+            prefix_second = *wall_second;
+        } else if (*wall_second != prefix_second) {
+            isodatetime_detail::write_time_of_day(prefix + 10, static_cast<std::uint32_t>(*wall_second - day * 86400));
+            prefix_second = *wall_second;
+        }
+
+        std::memcpy(out, prefix, prefix_length);
+        char* tail = out + prefix_length;
+        if (layout.fraction_digits != 0) {
+            isodatetime_detail::write_fraction(tail, nanoseconds, layout.fraction_digits);
+            tail += layout.fraction_digits + 1;
+        }
+        if (layout.zulu)
+            *tail = 'Z';
+        else if (layout.offset)
+            isodatetime_detail::write_utc_offset(tail, wall_offset);
+    }
+    return count;
+}
+
+/**
+ * @brief format_batch with the input split into contiguous spans formatted on separate threads.
+ *
+ * Every record is fixed-width, so span k writes straight into its own slice of the buffer and
+ * the threads share no mutable state; the output is byte-identical to format_batch. Spans are
+ * whole multiples of 64 records and at least parallel_batch_min_records long, so small batches
+ * stay on the calling thread, which always formats the first span itself.
+ *
+ * @param format Output format.
+ * @param time_points Times to format.
+ * @param count Number of time_points.
+ * @param buffer Destination buffer; no null terminators are written.
+ * @param size Capacity of the destination buffer, at least count * formatted_length(format) bytes.
+ * @param threads Maximum number of threads including the caller; 0 for hardware_concurrency.
+ * @return As format_batch: count, the index of the first record that is not renderable, or 0
+ *         if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_batch_parallel(Format format, const std::chrono::time_point<std::chrono::system_clock>* time_points, std::size_t count,
+                                               char* buffer, std::size_t size, unsigned threads)
+{
+    const std::size_t length = formatted_length(format);
+    if (time_points == nullptr || buffer == nullptr || count > size / length)
+        return 0;
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t spans = std::min<std::size_t>(threads, std::max<std::size_t>(1, count / isodatetime_detail::parallel_batch_min_records));
+    if (spans <= 1)
+        return format_batch(format, time_points, count, buffer, size);
+
+    const std::size_t span_records = ((count + spans - 1) / spans + 63) / 64 * 64;
+    std::vector<std::size_t> written(spans, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(spans - 1);
+    const auto run_span = [&, length](std::size_t span) {
+        const std::size_t first = std::min(count, span * span_records);
+        const std::size_t records = std::min(count - first, span_records);
+        written[span] = records == 0 ? 0 : format_batch(format, time_points + first, records, buffer + first * length, records * length);
+    };
+    for (std::size_t span = 1; span < spans; ++span)
+        workers.emplace_back(run_span, span);
+    run_span(0);
+    for (auto& worker : workers)
+        worker.join();
+
+    // The first short span marks the first record that could not be rendered
+    for (std::size_t span = 0; span < spans; ++span) {
+        const std::size_t first = std::min(count, span * span_records);
+        if (written[span] != std::min(count - first, span_records))
+            return first + written[span];
+    }
+    return count;
+}
+
+static_assert(std::is_trivially_copyable_v<ISODateTime::IsoStamp>, "IsoStamp must stay memcpy-able");
+static_assert(std::is_trivially_copyable_v<ISODateTime::CompactTime>, "CompactTime must stay memcpy-able");
+static_assert(std::is_trivially_copyable_v<ISODateTime::DeferredStamp>, "DeferredStamp must stay memcpy-able");
+static_assert(std::is_trivially_copyable_v<ISODateTime::FormatPlan>, "FormatPlan must stay shareable by copy");
+static_assert(isodatetime_detail::counter_count == ISODateTime::format_count + 20, "every counter slot needs a Counters field");
+static_assert(ISODateTime::compile_format("%FT%T.%3N")->step_count == 2, "aligned prefix fields must merge into one copy");
+static_assert(sizeof(ISODateTime::IsoStamp::data) > ISODateTime::iso_date_timestamp_ns_offset_length, "IsoStamp must hold the longest format");
+
+/**
+ * @brief Get one time_point in the selected Format as a fixed-capacity IsoStamp.
+ *
+ * IsoStamp is trivially copyable, so it can be passed through lock-free queues by memcpy
+ * with no allocator involvement.
+ *
+ * @param format Output format.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return The formatted text; length is 0 if the time is not renderable.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(Format format, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    IsoStamp result{};
+    result.length = static_cast<std::uint8_t>(ISODateTime::format(format, result.data, sizeof(result.data) - 1, get_input_time_point_or_current_system_time(time_point)));
+    result.data[result.length] = '\0';
+    return result;
+}
+
+/**
+ * @brief Get the current system time in the selected Format as a fixed-capacity IsoStamp.
+ * @param format Output format.
+ * @return The formatted text.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(Format format) noexcept
+{
+    return stamp(format, std::nullopt);
+}
+
+/**
+ * @brief Parse ISO 8601 text produced by the local-time functions back into a time_point.
+ *
+ * Accepts the date, date-time and timestamp shapes (3, 6 or 9 fraction digits). Text without
+ * a trailing 'Z' is read as local time; with a 'Z' it is read as UTC, and with a +HH:MM offset
+ * (the *_offset functions) it is converted by that offset without consulting the local zone.
+ *
+ * @param text Text to parse.
+ * @return The time_point, or std::nullopt if the text is not in one of the accepted formats or
+ *         names a time outside the range of system_clock.
+ */
+ISODATETIME_INLINE std::optional<std::chrono::time_point<std::chrono::system_clock>> ISODateTime::parse_iso(std::string_view text) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::parse_calls);
+    isodatetime_detail::parsed_fields fields{};
+    if (!isodatetime_detail::parse_fields(text, fields))
+        return std::nullopt;
+    if (fields.zulu || fields.has_offset)
+        return isodatetime_detail::make_time_point(isodatetime_detail::fields_to_seconds(fields) - fields.offset, fields.nanoseconds);
+    const auto seconds = isodatetime_detail::local_seconds_to_utc(isodatetime_detail::fields_to_seconds(fields));
+    if (!seconds)
+        return std::nullopt;
+    return isodatetime_detail::make_time_point(*seconds, fields.nanoseconds);
+}
+
+/**
+ * @brief Parse ISO 8601 text produced by the UTC functions back into a time_point.
+ *
+ * Accepts the same shapes as parse_iso, but text is always read as UTC, so the date-only
+ * output of get_current_utc_iso_date round-trips. An explicit +HH:MM offset is still applied.
+ * This is the fast path: no time zone lookup and no library calls.
+ *
+ * @param text Text to parse.
+ * @return The time_point, or std::nullopt if the text is not in one of the accepted formats or
+ *         names a time outside the range of system_clock.
+ */
+ISODATETIME_INLINE std::optional<std::chrono::time_point<std::chrono::system_clock>> ISODateTime::parse_utc_iso(std::string_view text) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::parse_calls);
+    isodatetime_detail::parsed_fields fields{};
+    if (!isodatetime_detail::parse_fields(text, fields))
+        return std::nullopt;
+    return isodatetime_detail::make_time_point(isodatetime_detail::fields_to_seconds(fields) - fields.offset, fields.nanoseconds);
+}
+
+/**
+ * @brief Parse a batch of fixed-width UTC timestamps (YYYY-MM-DDTHH:MM:SS.mmmZ) in one call.
+ *
+ * Record i starts at records + i * stride and must be exactly utc_iso_date_timestamp_length
+ * characters. Digits and separators are validated and converted 16 bytes at a time with
+ * SSSE3 or NEON where the CPU supports it, falling back to a scalar kernel otherwise. A bad
+ * record yields std::nullopt in its slot and does not stop the batch.
+ *
+ * @param records Start of the first record.
+ * @param stride Distance in bytes between consecutive records, at least utc_iso_date_timestamp_length.
+ * @param count Number of records.
+ * @param results Receives one parsed time_point, or std::nullopt, per record.
+ * @return Number of records parsed successfully.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::parse_utc_iso_timestamps(const char* records, std::size_t stride, std::size_t count,
+                                                  std::optional<std::chrono::time_point<std::chrono::system_clock>>* results) noexcept
+{
+    if (records == nullptr || results == nullptr || stride < utc_iso_date_timestamp_length)
+        return 0;
+
+    const auto kernel = isodatetime_detail::get_timestamp_body_kernel();
+    std::size_t parsed = 0;
+    isodatetime_detail::count(isodatetime_detail::counter::parse_calls, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const char* record = records + i * stride;
+        isodatetime_detail::parsed_fields fields{};
+        if (kernel(record, fields) && record[23] == 'Z' && isodatetime_detail::fields_in_range(fields))
+            results[i] = isodatetime_detail::make_time_point(isodatetime_detail::fields_to_seconds(fields), fields.nanoseconds);
+        else
+            results[i] = std::nullopt;
+        parsed += results[i].has_value();
+    }
+    return parsed;
+}
+
+/**
+ * @brief Map text produced by any Format to a 64-bit key that sorts like the time it names.
+ *
+ * The key packs the civil fields from bit 59 down: year:14 month:4 day:5 hour:5 minute:6
+ * second:6 microsecond:20, so key >> 37 is a day bucket and key >> 32 an hour bucket. 'Z' and
+ * local text are keyed as written (local text sorts by its wall clock); +HH:MM text is moved to
+ * UTC first, so it shares one timeline with 'Z' text. Nanosecond digits are dropped, so keys
+ * never decrease but equal keys can differ below the microsecond. Characters are checked eight
+ * at a time at fixed positions and only offset text needs calendar arithmetic.
+ *
+ * @param text Text to key.
+ * @return The key (always non-zero), or std::nullopt if text does not have one of the shapes
+ *         the Formats produce or a field is out of range.
+ */
+ISODATETIME_INLINE std::optional<std::uint64_t> ISODateTime::sortable_key(std::string_view text) noexcept
+{
+    const std::uint64_t key = isodatetime_detail::read_sortable_key(text.data(), text.size());
+    if (key == 0)
+        return std::nullopt;
+    return key;
+}
+
+/**
+ * @brief sortable_key for a batch of fixed-width records, e.g. one column of an export.
+ *
+ * Record i starts at records + i * stride and is length characters long. A bad record gets
+ * key 0, below every valid key, and does not stop the batch, so the keys can go straight into
+ * a radix sort.
+ *
+ * @param records Start of the first record.
+ * @param stride Distance in bytes between consecutive records, at least length.
+ * @param length Length of every record.
+ * @param count Number of records.
+ * @param keys Receives one key per record.
+ * @return Number of records with a valid key.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::sortable_keys(const char* records, std::size_t stride, std::size_t length, std::size_t count,
+                                       std::uint64_t* keys) noexcept
+{
+    if (records == nullptr || keys == nullptr || stride < length)
+        return 0;
+
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = isodatetime_detail::read_sortable_key(records + i * stride, length);
+        valid += keys[i] != 0 ? 1 : 0;
+    }
+    return valid;
+}
+
+/**
+ * @brief Write a duration as ISO 8601 text in its shortest exact form.
+ *
+ * Days, hours, minutes and seconds are written with zero parts left out and the seconds
+ * fraction trimmed of trailing zeros, so 1500 us is PT0.0015S, 26 h is P1DT2H and zero is
+ * PT0S. Days are not folded into weeks, months or years, which have no fixed length.
+ *
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer in bytes; iso_duration_max_length always suffices.
+ * @param duration Duration to write; negative durations get a leading '-'.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_iso_duration(char* buffer, std::size_t size, const std::chrono::nanoseconds& duration) noexcept
+{
+    char text[iso_duration_max_length];
+    const std::size_t length = isodatetime_detail::write_iso_duration(text, duration.count());
+    if (buffer == nullptr || length > size)
+        return 0;
+    std::memcpy(buffer, text, length);
+    return length;
+}
+
+/**
+ * @brief Get a duration as ISO 8601 text, as written by format_iso_duration.
+ * @param duration Duration to format.
+ * @return ISO 8601 duration string.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_iso_duration(const std::chrono::nanoseconds& duration)
+{
+    char text[iso_duration_max_length];
+    return {text, isodatetime_detail::write_iso_duration(text, duration.count())};
+}
+
+/**
+ * @brief Parse an ISO 8601 duration such as PT0.25S, P1DT2H or -PT5M.
+ *
+ * Weeks, days, hours, minutes and seconds are accepted in that order, with a fraction on the
+ * last part; years and months have no fixed length and are rejected.
+ *
+ * @param text Text to parse.
+ * @return The duration, or std::nullopt if text is not of that form or does not fit in nanoseconds.
+ */
+ISODATETIME_INLINE std::optional<std::chrono::nanoseconds> ISODateTime::parse_iso_duration(std::string_view text) noexcept
+{
+    std::int64_t nanoseconds = 0;
+    if (!isodatetime_detail::parse_iso_duration_text(text, nanoseconds))
+        return std::nullopt;
+    return std::chrono::nanoseconds(nanoseconds);
+}
+
+/**
+ * @brief Write an interval as start/end, each end in the given Format.
+ * @param format Format of both ends.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least 2 * formatted_length(format) + 1 bytes.
+ * @param interval Interval to write.
+ * @return Number of bytes written, or 0 if the buffer is too small or an end is not renderable.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_iso_interval(Format format, char* buffer, std::size_t size, const Interval& interval) noexcept
+{
+    const std::size_t length = formatted_length(format);
+    if (buffer == nullptr || size < 2 * length + 1)
+        return 0;
+    if (ISODateTime::format(format, buffer, length, interval.start) == 0 || ISODateTime::format(format, buffer + length + 1, length, interval.end) == 0)
+        return 0;
+    buffer[length] = '/';
+    return 2 * length + 1;
+}
+
+/**
+ * @brief Get an interval as start/end ISO 8601 text, as written by format_iso_interval.
+ * @param format Format of both ends.
+ * @param interval Interval to format.
+ * @return ISO 8601 interval string, or an empty string if an end is not renderable.
+ */
+ISODATETIME_INLINE std::string ISODateTime::get_iso_interval(Format format, const Interval& interval)
+{
+    char text[iso_interval_max_length];
+    return {text, format_iso_interval(format, text, sizeof(text), interval)};
+}
+
+/**
+ * @brief Parse an ISO 8601 interval: start/end, start/duration or duration/end.
+ *
+ * Each time is read by parse_iso (so 'Z', +HH:MM and local text are all accepted) and each
+ * duration by parse_iso_duration.
+ *
+ * @param text Text to parse.
+ * @return The interval, or std::nullopt if either side does not parse, both are durations, or
+ *         the computed end does not fit the clock.
+ */
+ISODATETIME_INLINE std::optional<ISODateTime::Interval> ISODateTime::parse_iso_interval(std::string_view text) noexcept
+{
+    const std::size_t slash = text.find('/');
+    if (slash == std::string_view::npos)
+        return std::nullopt;
+    const std::string_view first = text.substr(0, slash);
+    const std::string_view second = text.substr(slash + 1);
+    const auto is_duration = [](std::string_view side) {
+        return !side.empty() && (side[0] == 'P' || (side.size() > 1 && (side[0] == '-' || side[0] == '+') && side[1] == 'P'));
+    };
+
+    if (is_duration(first)) {
+        const auto duration = parse_iso_duration(first);
+        const auto end = parse_iso(second);
+        if (!duration || !end || duration->count() == std::numeric_limits<std::int64_t>::min())
+            return std::nullopt;
+        const auto start = isodatetime_detail::add_duration(*end, -duration->count());
+        if (!start)
+            return std::nullopt;
+        return Interval{*start, *end};
+    }
+    const auto start = parse_iso(first);
+    if (!start)
+        return std::nullopt;
+    if (is_duration(second)) {
+        const auto duration = parse_iso_duration(second);
+        if (!duration)
+            return std::nullopt;
+        const auto end = isodatetime_detail::add_duration(*start, duration->count());
+        if (!end)
+            return std::nullopt;
+        return Interval{*start, *end};
+    }
+    const auto end = parse_iso(second);
+    if (!end)
+        return std::nullopt;
+    return Interval{*start, *end};
+}
+
+/**
+ * @brief Parse an ISO 8601 week date (YYYY-Www-D) into a calendar date.
+ * @param text Exactly 10 characters; week 01-52, or 53 in years that have one, and weekday 1 (Monday) to 7.
+ * @return The calendar date, or std::nullopt if the text is malformed or the week does not exist.
+ */
+ISODATETIME_INLINE std::optional<ISODateTime::CivilDate> ISODateTime::parse_iso_week_date(std::string_view text) noexcept
+{
+    unsigned year = 0;
+    unsigned week = 0;
+    unsigned weekday = 0;
+    if (text.size() != iso_week_date_length || text[4] != '-' || text[5] != 'W' || text[8] != '-'
+        || !isodatetime_detail::read_digits(text.data(), 4, year) || !isodatetime_detail::read_digits(text.data() + 6, 2, week)
+        || !isodatetime_detail::read_digits(text.data() + 9, 1, weekday))
+        return std::nullopt;
+    // December 28 always falls in the last week of its week-numbering year
+    const unsigned weeks = week_date_from_days(days_from_civil(year, 12, 28)).week;
+    if (week < 1 || week > weeks || weekday < 1 || weekday > 7)
+        return std::nullopt;
+    return civil_from_days(days_from_week_date(year, week, weekday));
+}
+
+/**
+ * @brief Parse an ISO 8601 ordinal date (YYYY-DDD) into a calendar date.
+ * @param text Exactly 8 characters; day 001-365, or 366 in leap years.
+ * @return The calendar date, or std::nullopt if the text is malformed or the day does not exist.
+ */
+ISODATETIME_INLINE std::optional<ISODateTime::CivilDate> ISODateTime::parse_iso_ordinal_date(std::string_view text) noexcept
+{
+    unsigned year = 0;
+    unsigned day = 0;
+    if (text.size() != iso_ordinal_date_length || text[4] != '-'
+        || !isodatetime_detail::read_digits(text.data(), 4, year) || !isodatetime_detail::read_digits(text.data() + 5, 3, day))
+        return std::nullopt;
+    const unsigned days_in_year = isodatetime_detail::days_in_month(year, 2) == 29 ? 366 : 365;
+    if (day < 1 || day > days_in_year)
+        return std::nullopt;
+    return civil_from_days(days_from_civil(year, 1, 1) + day - 1);
+}
+
+/**
+ * @brief Rewrite the first ISO timestamp of every line of a log file as UTC 'Z' text.
+ *
+ * The input is memory-mapped (or read into memory where it cannot be), split into chunks of
+ * about options.chunk_size bytes at line ends, and converted by options.threads worker threads
+ * one wave of chunks at a time, while the previous wave is written to the output in order with
+ * one large write per chunk. Timestamps are found at options.column, or by scanning each line
+ * for the first "YYYY-MM-DDTHH:MM:SS" with an optional 3, 6 or 9 digit fraction. Local times
+ * (no designator) are resolved like parse_iso, once per distinct second; +HH:MM / -HH:MM times
+ * are shifted by their offset; the fraction is kept. Times that are already UTC, lines without
+ * a timestamp and the rest of every line are copied byte for byte. enable_local_offset_cache()
+ * speeds up logs with few lines per second.
+ *
+ * @param input_path File to read.
+ * @param output_path File to create or truncate; must not be the input file.
+ * @param options Timestamp column, thread count (0 for hardware_concurrency) and chunk size (0 for 8 MiB).
+ * @return Line and conversion counts; ok is false if a file could not be opened, mapped or written.
+ */
+ISODATETIME_INLINE ISODateTime::LogRewriteResult ISODateTime::rewrite_log_timestamps(const std::string& input_path, const std::string& output_path,
+                                                                                     const LogRewriteOptions& options)
+{
+    LogRewriteResult result{false, 0, 0, 0};
+    const isodatetime_detail::mapped_input input(input_path);
+    if (!input.ok() || input_path == output_path || input.same_file(output_path))
+        return result;
+    std::FILE* output = std::fopen(output_path.c_str(), "wb");
+    if (output == nullptr)
+        return result;
+
+    const unsigned threads = options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t chunk_size = options.chunk_size != 0 ? options.chunk_size : std::size_t{8} << 20;
+    auto chunks = isodatetime_detail::split_log_chunks(input.data(), input.size(), chunk_size);
+
+    // Double-buffered waves: threads convert wave w into one set of buffers while this thread writes wave w - 1 from the other
+    std::vector<isodatetime_detail::log_chunk> buffers[2];
+    buffers[0].resize(std::min<std::size_t>(threads, chunks.size()));
+    buffers[1].resize(buffers[0].size());
+    bool written_ok = true;
+    const auto write_wave = [&](std::vector<isodatetime_detail::log_chunk>& wave, std::size_t used) {
+        for (std::size_t i = 0; i < used; ++i) {
+            written_ok = written_ok && std::fwrite(wave[i].output.get(), 1, wave[i].length, output) == wave[i].length;
+            result.lines += wave[i].lines;
+            result.converted += wave[i].converted;
+            result.bytes_written += wave[i].length;
+        }
+    };
+
+    std::size_t previous_used = 0;
+    for (std::size_t first = 0, wave = 0; first < chunks.size() && written_ok; first += threads, ++wave) {
+        auto& current = buffers[wave % 2];
+        const std::size_t used = std::min<std::size_t>(threads, chunks.size() - first);
+        std::vector<std::thread> workers;
+        workers.reserve(used);
+        for (std::size_t i = 0; i < used; ++i) {
+            current[i].begin = chunks[first + i].begin;
+            current[i].end = chunks[first + i].end;
+            workers.emplace_back(isodatetime_detail::rewrite_log_chunk, std::ref(current[i]), options.column);
+        }
+        if (wave > 0)
+            write_wave(buffers[(wave - 1) % 2], previous_used);
+        for (auto& worker : workers)
+            worker.join();
+        previous_used = used;
+        if (first + threads >= chunks.size())
+            write_wave(current, used);
+    }
+
+    const bool closed = std::fclose(output) == 0;
+    result.ok = written_ok && closed;
+    return result;
+}
+
+/**
+ * @brief Rewrite every line's first timestamp as UTC, scanning each line, on all cores in 8 MiB chunks.
+ * @param input_path File to read.
+ * @param output_path File to create or truncate; must not be the input file.
+ * @return Line and conversion counts; ok is false if a file could not be opened, mapped or written.
+ */
+ISODATETIME_INLINE ISODateTime::LogRewriteResult ISODateTime::rewrite_log_timestamps(const std::string& input_path, const std::string& output_path)
+{
+    return rewrite_log_timestamps(input_path, output_path, LogRewriteOptions{scan_for_timestamp, 0, 0});
+}
+
+/**
+ * @brief Select the clock read by the no-argument functions.
+ *
+ * realtime_coarse trades resolution for a much cheaper read and is only available on Linux.
+ * tsc reads the x86 time-stamp counter and converts it with a rate calibrated against
+ * system_clock (a 10 ms spin on first selection), re-anchoring about once a second. A source
+ * that is not available on this platform or CPU leaves system selected.
+ *
+ * @param source Clock to use.
+ */
+ISODATETIME_INLINE void ISODateTime::set_clock_source(ClockSource source)
+{
+#if !defined(__linux__)
+    if (source == ClockSource::realtime_coarse)
+        source = ClockSource::system;
+#endif
+    if (source == ClockSource::tsc) {
+        const std::lock_guard<std::mutex> lock(isodatetime_detail::tsc_anchors_writer);
+        if (isodatetime_detail::tsc_anchors.load().nanoseconds_per_tick == 0 && !isodatetime_detail::resync_tsc_anchor())
+            source = ClockSource::system;
+    }
+    isodatetime_detail::clock_source.store(source, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the clock currently read by the no-argument functions.
+ * @return The effective clock source, after any fallback applied by set_clock_source.
+ */
+ISODATETIME_INLINE ISODateTime::ClockSource ISODateTime::get_clock_source() noexcept
+{
+    return isodatetime_detail::clock_source.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Make the times read by the no-argument functions monotonic.
+ *
+ * With ClockSource::system the time is read from steady_clock against a system_clock anchor
+ * refreshed about once a second, so the cost stays one clock read; realtime_coarse and tsc are
+ * read as before. Either way each reading is then raised to one tick past the previous one on
+ * the thread (per_thread, a thread_local compare) or in the process (global, a compare-exchange
+ * on one shared atomic), so timestamps come out non-decreasing and never need re-sorting.
+ * When the wall clock steps back, by an NTP correction or a stepped leap second, the times
+ * advance by a tick per read until the clock catches up, instead of repeating earlier ones.
+ * Explicit time_point arguments are never changed, and the high-water marks persist when the
+ * mode is switched off and on.
+ *
+ * @param mode Ordering guarantee; off restores plain reads of the clock source.
+ */
+ISODATETIME_INLINE void ISODateTime::set_monotonic_mode(MonotonicMode mode) noexcept
+{
+    isodatetime_detail::monotonic_mode.store(mode, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the ordering guarantee currently applied to the no-argument functions.
+ * @return The mode last passed to set_monotonic_mode, off by default.
+ */
+ISODATETIME_INLINE ISODateTime::MonotonicMode ISODateTime::get_monotonic_mode() noexcept
+{
+    return isodatetime_detail::monotonic_mode.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start a background thread that publishes the current local and UTC millisecond timestamps.
+ *
+ * The thread wakes just after every multiple of resolution, renders both timestamps from the
+ * selected clock source and publishes them in a seqlock; readers copy the latest pair without
+ * locking or formatting. A published value is up to one resolution (plus scheduling latency)
+ * old, so a resolution coarser than 1 ms repeats the same milliseconds. Calling it again
+ * restarts the thread with the new settings.
+ *
+ * @param resolution Interval between publications; values below 1 microsecond are raised to it.
+ * @param serve_current_timestamps Whether get_current_[utc_]iso_date_timestamp() and
+ *        format_current_[utc_]iso_date_timestamp(buffer, size) return the published text
+ *        instead of reading the clock.
+ */
+ISODATETIME_INLINE void ISODateTime::start_ticker(const std::chrono::microseconds& resolution, bool serve_current_timestamps)
+{
+    isodatetime_detail::ticker.start(std::max<std::chrono::nanoseconds>(resolution, std::chrono::microseconds(1)));
+    isodatetime_detail::ticker_serves_current.store(serve_current_timestamps, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stop and join the ticker thread; the no-argument functions read the clock again.
+ */
+ISODATETIME_INLINE void ISODateTime::stop_ticker()
+{
+    isodatetime_detail::ticker.stop();
+}
+
+/**
+ * @brief Get the ISO 8601 date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmm) last published by the ticker.
+ * @return The published text, or the current time formatted now if the ticker is not running.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::get_ticker_iso_date_timestamp() noexcept
+{
+    if (!isodatetime_detail::ticker_running.load(std::memory_order_acquire))
+        return stamp(Format::iso_date_timestamp);
+    return isodatetime_detail::load_ticker_slot().local;
+}
+
+/**
+ * @brief Get the ISO 8601 UTC date, time, and milliseconds (YYYY-MM-DDTHH:MM:SS.mmmZ) last published by the ticker.
+ * @return The published text, or the current time formatted now if the ticker is not running.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::get_ticker_utc_iso_date_timestamp() noexcept
+{
+    if (!isodatetime_detail::ticker_running.load(std::memory_order_acquire))
+        return stamp(Format::utc_iso_date_timestamp);
+    return isodatetime_detail::load_ticker_slot().utc;
+}
+
+/**
+ * @brief Load an IANA time zone from tzdata, or return it from the process-wide cache.
+ *
+ * The first call for a name reads and parses its TZif file under a lock; the zone then stays
+ * loaded for the life of the process, so the handle can be shared freely between threads.
+ *
+ * @param name IANA zone name, e.g. "America/New_York".
+ * @return The zone handle, or std::nullopt if the zone cannot be found or parsed.
+ */
+ISODATETIME_INLINE std::optional<ISODateTime::TimeZone> ISODateTime::load_zone(std::string_view name)
+{
+    const isodatetime_detail::time_zone* zone = isodatetime_detail::find_or_load_time_zone(name);
+    if (zone == nullptr)
+        return std::nullopt;
+    return TimeZone{zone};
+}
+
+/**
+ * @brief Get the IANA name a zone was loaded as.
+ * @param zone Zone handle from load_zone.
+ * @return The name, or an empty view for an empty handle.
+ */
+ISODATETIME_INLINE std::string_view ISODateTime::zone_name(const TimeZone& zone) noexcept
+{
+    return zone.data == nullptr ? std::string_view() : std::string_view(zone.data->name);
+}
+
+/**
+ * @brief Get the UTC offset in effect in a zone at a time_point.
+ * @param zone Zone handle from load_zone.
+ * @param time_point Time to look up.
+ * @return Offset east of UTC, or zero for an empty handle.
+ */
+ISODATETIME_INLINE std::chrono::seconds ISODateTime::utc_offset(const TimeZone& zone, const std::chrono::time_point<std::chrono::system_clock>& time_point) noexcept
+{
+    if (zone.data == nullptr)
+        return std::chrono::seconds(0);
+    std::uint32_t nanoseconds = 0;
+    return std::chrono::seconds(isodatetime_detail::zone_offset_at(*zone.data, static_cast<std::int64_t>(isodatetime_detail::split_time_point(time_point, nanoseconds))));
+}
+
+/**
+ * @brief Write one time_point as local time in a zone, followed by its UTC offset.
+ *
+ * The Format selects the shape (date, date-time, or 3, 6 or 9 fraction digits); local and
+ * UTC variants render identically, e.g. 2025-08-09T10:00:00.123+01:00. Dates carry no offset.
+ *
+ * @param format Output format.
+ * @param zone Zone handle from load_zone.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least zoned_length(format) bytes.
+ * @param time_point Time to format.
+ * @return Number of bytes written, or 0 if the buffer is too small or the handle is empty.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format(Format format, const TimeZone& zone, char* buffer, std::size_t size, const std::chrono::time_point<std::chrono::system_clock>& time_point) noexcept
+{
+    if (zone.data == nullptr)
+        return 0;
+    isodatetime_detail::count(isodatetime_detail::counter::zoned_calls);
+    return isodatetime_detail::write_zoned_text(buffer, size, *zone.data, isodatetime_detail::get_format_layout(format), time_point);
+}
+
+/**
+ * @brief Get one time_point in a zone as a fixed-capacity IsoStamp.
+ * @param format Output format.
+ * @param zone Zone handle from load_zone.
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return The formatted text; length is 0 if the time is not renderable or the handle is empty.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(Format format, const TimeZone& zone, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    IsoStamp result{};
+    result.length = static_cast<std::uint8_t>(ISODateTime::format(format, zone, result.data, sizeof(result.data) - 1, get_input_time_point_or_current_system_time(time_point)));
+    result.data[result.length] = '\0';
+    return result;
+}
+
+/**
+ * @brief Capture a time_point in compact form, together with the local UTC offset in effect at it.
+ *
+ * Costs the per-thread seconds cache lookup (a localtime conversion once per second) and no
+ * formatting; render the result later with format or stamp, on any thread.
+ *
+ * @param time_point Optional system_clock::time_point. If not provided, the current system time is used.
+ * @return The capture; offset_quarters is compact_unknown_offset if the offset is not a whole number of quarter hours.
+ */
+ISODATETIME_INLINE ISODateTime::CompactTime ISODateTime::capture_compact(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::compact_captures);
+    const auto now = get_input_time_point_or_current_system_time(time_point);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(now, nanoseconds);
+    const std::int32_t offset = isodatetime_detail::get_cached_second(seconds, false).utc_offset;
+    CompactTime result{};
+    result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    result.offset_quarters = offset % 900 == 0 && offset / 900 > compact_unknown_offset && offset / 900 <= 127 ? static_cast<std::int8_t>(offset / 900) : compact_unknown_offset;
+    return result;
+}
+
+/**
+ * @brief Capture the current time in compact form, together with the local UTC offset in effect.
+ * @return The capture.
+ */
+ISODATETIME_INLINE ISODateTime::CompactTime ISODateTime::capture_compact() noexcept
+{
+    return capture_compact(std::nullopt);
+}
+
+/**
+ * @brief Serialise a capture into compact_time_length bytes: the nanoseconds little-endian, then the offset byte.
+ * @param time Capture to serialise.
+ * @param out Destination; must have room for compact_time_length bytes.
+ */
+ISODATETIME_INLINE void ISODateTime::encode_compact(const CompactTime& time, unsigned char* out) noexcept
+{
+    const auto bits = static_cast<std::uint64_t>(time.nanoseconds);
+    for (std::size_t i = 0; i < 8; ++i)
+        out[i] = static_cast<unsigned char>(bits >> (i * 8));
+    out[8] = static_cast<unsigned char>(time.offset_quarters);
+}
+
+/**
+ * @brief Deserialise a capture written by encode_compact.
+ * @param in Source; must hold compact_time_length bytes.
+ * @return The capture.
+ */
+ISODATETIME_INLINE ISODateTime::CompactTime ISODateTime::decode_compact(const unsigned char* in) noexcept
+{
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < 8; ++i)
+        bits |= static_cast<std::uint64_t>(in[i]) << (i * 8);
+    CompactTime result{};
+    result.nanoseconds = static_cast<std::int64_t>(bits);
+    result.offset_quarters = static_cast<std::int8_t>(in[8]);
+    return result;
+}
+
+/**
+ * @brief Render a capture in the selected Format into a caller-supplied buffer.
+ *
+ * UTC formats render the captured instant; local and offset formats render it at the offset
+ * captured with it, so the text matches what the synchronous local function would have
+ * produced at capture time.
+ *
+ * @param format Output format.
+ * @param time Capture to render.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least formatted_length(format) bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format(Format format, const CompactTime& time, char* buffer, std::size_t size) noexcept
+{
+    isodatetime_detail::count_format(format);
+    return isodatetime_detail::write_compact_text(buffer, size, isodatetime_detail::get_format_layout(format), formatted_length(format), time);
+}
+
+/**
+ * @brief Render a capture in the selected Format as a fixed-capacity IsoStamp.
+ * @param format Output format.
+ * @param time Capture to render.
+ * @return The formatted text; length is 0 if the time is not renderable.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(Format format, const CompactTime& time) noexcept
+{
+    IsoStamp result{};
+    result.length = static_cast<std::uint8_t>(ISODateTime::format(format, time, result.data, sizeof(result.data) - 1));
+    result.data[result.length] = '\0';
+    return result;
+}
+
+/**
+ * @brief Render a batch of captures as consecutive fixed-width records.
+ *
+ * Record i occupies [i * formatted_length(format), (i + 1) * formatted_length(format)) of the
+ * buffer. Captures from the same second share one rendered prefix through the per-thread
+ * seconds cache.
+ *
+ * @param format Output format.
+ * @param times Captures to render.
+ * @param count Number of captures.
+ * @param buffer Destination buffer; no null terminators are written.
+ * @param size Capacity of the destination buffer, at least count * formatted_length(format) bytes.
+ * @return Number of records written: count, fewer if a capture is not renderable, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format_compact_batch(Format format, const CompactTime* times, std::size_t count, char* buffer, std::size_t size) noexcept
+{
+    const auto layout = isodatetime_detail::get_format_layout(format);
+    const std::size_t length = formatted_length(format);
+    if (times == nullptr || buffer == nullptr || count > size / length)
+        return 0;
+    isodatetime_detail::count(isodatetime_detail::counter::batch_records, count);
+    for (std::size_t i = 0; i < count; ++i)
+        if (isodatetime_detail::write_compact_text(buffer + i * length, length, layout, length, times[i]) == 0)
+            return i;
+    return count;
+}
+
+/**
+ * @brief Pair a time_point with the Format it should later be rendered in.
+ * @param format Output format.
+ * @param time_point Optional system_clock::time_point. If not provided, the current time from the selected clock source is used.
+ * @return The capture; trivially copyable, so it can go through any queue by memcpy.
+ */
+ISODATETIME_INLINE ISODateTime::DeferredStamp ISODateTime::capture(Format format, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    return {get_input_time_point_or_current_system_time(time_point), format};
+}
+
+/**
+ * @brief Pair the current time with the Format it should later be rendered in; costs one clock read.
+ * @param format Output format.
+ * @return The capture.
+ */
+ISODATETIME_INLINE ISODateTime::DeferredStamp ISODateTime::capture(Format format) noexcept
+{
+    return capture(format, std::nullopt);
+}
+
+/**
+ * @brief Render a DeferredStamp into a caller-supplied buffer, on any thread.
+ *
+ * Goes through format(), which is the path behind every get_current_* function, so the text
+ * equals the synchronous call with the same time_point. Local formats resolve the offset when
+ * rendered; capture with an *_offset Format, or use capture_compact, to pin it at capture time.
+ *
+ * @param deferred Capture to render.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least formatted_length(deferred.format) bytes.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format(const DeferredStamp& deferred, char* buffer, std::size_t size) noexcept
+{
+    return format(deferred.format, buffer, size, deferred.time_point);
+}
+
+/**
+ * @brief Render a DeferredStamp as a fixed-capacity IsoStamp.
+ * @param deferred Capture to render.
+ * @return The formatted text; length is 0 if the time is not renderable.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(const DeferredStamp& deferred) noexcept
+{
+    return stamp(deferred.format, deferred.time_point);
+}
+
+/**
+ * @brief Render a DeferredStamp as a std::string, as the matching get_current_* function would.
+ * @param deferred Capture to render.
+ * @return The formatted text.
+ */
+ISODATETIME_INLINE std::string ISODateTime::to_string(const DeferredStamp& deferred)
+{
+    return stamp(deferred).str();
+}
+
+/**
+ * @brief Write one time_point through a compiled FormatPlan into a caller-supplied buffer.
+ *
+ * Date and time fields come from the same per-thread seconds cache as the built-in formats, so
+ * a custom pattern costs the same as a built-in Format of the same length.
+ *
+ * @param plan Plan from compile_format.
+ * @param buffer Destination buffer; no null terminator is written.
+ * @param size Capacity of the destination buffer, at least plan.length bytes.
+ * @param time_point Time to format.
+ * @return Number of bytes written, or 0 if the buffer is too small or the year is outside 0000-9999.
+ */
+ISODATETIME_INLINE std::size_t ISODateTime::format(const FormatPlan& plan, char* buffer, std::size_t size, const std::chrono::time_point<std::chrono::system_clock>& time_point) noexcept
+{
+    isodatetime_detail::count(isodatetime_detail::counter::plan_calls);
+    std::uint32_t nanoseconds = 0;
+    const auto seconds = isodatetime_detail::split_time_point(time_point, nanoseconds);
+    return isodatetime_detail::write_planned_text(buffer, size, plan, isodatetime_detail::get_cached_second(seconds, plan.utc), nanoseconds);
+}
+
+/**
+ * @brief Format a time_point through a compiled FormatPlan as a fixed-capacity IsoStamp.
+ * @param plan Plan from compile_format.
+ * @param time_point Optional system_clock::time_point. If not provided, the current time is used.
+ * @return The formatted text; length is 0 if the time is not renderable.
+ */
+ISODATETIME_INLINE ISODateTime::IsoStamp ISODateTime::stamp(const FormatPlan& plan, const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    IsoStamp result{};
+    result.length = static_cast<std::uint8_t>(format(plan, result.data, sizeof(result.data) - 1, get_input_time_point_or_current_system_time(time_point)));
+    result.data[result.length] = '\0';
+    return result;
+}
+
+/**
+ * @brief Snapshot of the instrumentation counters summed over all threads, live and exited.
+ *
+ * Values are relative to the last reset_counters(). Without ISODATETIME_ENABLE_INSTRUMENTATION
+ * nothing is counted and every field is zero. Each thread's counters are read untorn but not
+ * at one instant, so a snapshot taken under load may mix values a few calls apart.
+ *
+ * @return The counters.
+ */
+ISODATETIME_INLINE ISODateTime::Counters ISODateTime::get_counters()
+{
+    Counters counters{};
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+    std::uint64_t totals[isodatetime_detail::counter_count];
+    {
+        const std::lock_guard<std::mutex> lock(isodatetime_detail::counter_registry_writer);
+        isodatetime_detail::sum_counters(totals);
+        for (std::size_t i = 0; i < isodatetime_detail::counter_count; ++i)
+            totals[i] -= isodatetime_detail::counter_baseline[i];
+    }
+    const auto total = [&totals](isodatetime_detail::counter slot) { return totals[static_cast<std::size_t>(slot)]; };
+    for (std::size_t i = 0; i < format_count; ++i)
+        counters.calls_by_format[i] = totals[i];
+    counters.week_date_calls = total(isodatetime_detail::counter::week_date_calls);
+    counters.ordinal_date_calls = total(isodatetime_detail::counter::ordinal_date_calls);
+    counters.batch_records = total(isodatetime_detail::counter::batch_records);
+    counters.plan_calls = total(isodatetime_detail::counter::plan_calls);
+    counters.zoned_calls = total(isodatetime_detail::counter::zoned_calls);
+    counters.compact_captures = total(isodatetime_detail::counter::compact_captures);
+    counters.parse_calls = total(isodatetime_detail::counter::parse_calls);
+    counters.ticker_reads = total(isodatetime_detail::counter::ticker_reads);
+    counters.clock_reads = total(isodatetime_detail::counter::clock_reads);
+    counters.monotonic_clamps = total(isodatetime_detail::counter::monotonic_clamps);
+    counters.second_cache_hits = total(isodatetime_detail::counter::second_cache_hits);
+    counters.second_cache_misses = total(isodatetime_detail::counter::second_cache_misses);
+    counters.date_cache_hits = total(isodatetime_detail::counter::date_cache_hits);
+    counters.date_cache_misses = total(isodatetime_detail::counter::date_cache_misses);
+    counters.offset_table_hits = total(isodatetime_detail::counter::offset_table_hits);
+    counters.offset_table_misses = total(isodatetime_detail::counter::offset_table_misses);
+    counters.zone_index_hits = total(isodatetime_detail::counter::zone_index_hits);
+    counters.zone_index_misses = total(isodatetime_detail::counter::zone_index_misses);
+    counters.tm_conversion_ns = total(isodatetime_detail::counter::tm_conversion_ns);
+    counters.rendering_ns = total(isodatetime_detail::counter::rendering_ns);
+#endif
+    return counters;
+}
+
+/**
+ * @brief Make get_counters() count from zero again; a no-op without ISODATETIME_ENABLE_INSTRUMENTATION.
+ */
+ISODATETIME_INLINE void ISODateTime::reset_counters()
+{
+#if defined(ISODATETIME_ENABLE_INSTRUMENTATION)
+    const std::lock_guard<std::mutex> lock(isodatetime_detail::counter_registry_writer);
+    isodatetime_detail::sum_counters(isodatetime_detail::counter_baseline);
+#endif
+}
+
+// ---------- Private functions ----------
+
+/**
+ * @brief Return the provided time_point, or the current time from the selected clock source if none was given.
+ * @param time_point Optional system_clock::time_point.
+ * @return The provided time_point or the current system time.
+ */
+ISODATETIME_INLINE std::chrono::time_point<std::chrono::system_clock> ISODateTime::get_input_time_point_or_current_system_time(const std::optional<std::chrono::time_point<std::chrono::system_clock>>& time_point) noexcept
+{
+    if (time_point)
+        return *time_point;
+    return isodatetime_detail::read_clock();
+}
+
+#endif //ISODATETIME_IMPL_H
@@ -0,0 +1,554 @@
+//
+// Google Benchmark suite for ISODateTime.
+//
+// Build with -DISODATETIME_BUILD_BENCHMARKS=ON and run ISODateTime_bench. Every benchmark
+// reports ns/op and an allocs/op counter. The *_tp benchmarks pass an explicit time_point and
+// step it by a little over one second per iteration, so each call misses the per-thread seconds
+// cache (worst case), cycling through one hour of time_points. The *_now benchmarks read the
+// clock like the no-argument functions.
+//
+
+#include "ISODateTime.h"
+#if defined(ISODATETIME_BENCH_FMT)
+#include "ISODateTimeFormatter.h"
+#endif
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------- Allocation counting ----------
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC cannot see that the replacement operator new below is malloc-based
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static thread_local std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * @brief Report the heap allocations made by this thread during the timed loop as allocs/op.
+ */
+static void report_allocations(benchmark::State& state, std::size_t before)
+{
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocations - before), benchmark::Counter::kAvgIterations);
+}
+
+static int max_threads()
+{
+    const auto threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : static_cast<int>(threads);
+}
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+
+// A point near the present, so the local offset cache (when enabled) covers it
+static const time_point start_time = std::chrono::system_clock::now();
+static constexpr auto time_step = std::chrono::milliseconds(1001);
+static constexpr int time_steps = 3600;
+
+/**
+ * @brief The time_point following tp in the one-hour benchmark cycle.
+ */
+static time_point next_time_point(const time_point& tp)
+{
+    const auto next = tp + time_step;
+    return next < start_time + time_step * time_steps ? next : start_time;
+}
+
+// ---------- Generic drivers ----------
+
+/**
+ * @brief Benchmark a value-returning (std::string or IsoStamp) function taking an explicit time_point.
+ */
+template <typename Function>
+static void BM_string_tp(benchmark::State& state, Function function)
+{
+    auto tp = start_time;
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(tp));
+        tp = next_time_point(tp);
+    }
+    report_allocations(state, before);
+}
+
+/**
+ * @brief Benchmark a no-argument value-returning (std::string or IsoStamp) function.
+ */
+template <typename Function>
+static void BM_string_now(benchmark::State& state, Function function)
+{
+    const auto before = allocations;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(function());
+    report_allocations(state, before);
+}
+
+/**
+ * @brief Benchmark a buffer-writing function taking an explicit time_point.
+ */
+template <typename Function>
+static void BM_buffer_tp(benchmark::State& state, Function function)
+{
+    char buffer[64];
+    auto tp = start_time;
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(buffer, sizeof(buffer), tp));
+        benchmark::ClobberMemory();
+        tp = next_time_point(tp);
+    }
+    report_allocations(state, before);
+}
+
+/**
+ * @brief Benchmark a no-argument buffer-writing function.
+ */
+template <typename Function>
+static void BM_buffer_now(benchmark::State& state, Function function)
+{
+    char buffer[64];
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(buffer, sizeof(buffer)));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+}
+
+// ---------- get_current_* ----------
+
+#define ISODATETIME_BENCH_STRING(name)                                                                              \
+    BENCHMARK_CAPTURE(BM_string_tp, name, [](const time_point& tp) { return ISODateTime::name(tp); })             \
+        ->ThreadRange(1, max_threads());                                                                            \
+    BENCHMARK_CAPTURE(BM_string_now, name, [] { return ISODateTime::name(); })->ThreadRange(1, max_threads())
+
+ISODATETIME_BENCH_STRING(get_current_iso_date);
+ISODATETIME_BENCH_STRING(get_current_iso_date_time);
+ISODATETIME_BENCH_STRING(get_current_iso_date_timestamp);
+ISODATETIME_BENCH_STRING(get_current_iso_date_timestamp_us);
+ISODATETIME_BENCH_STRING(get_current_iso_date_timestamp_ns);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_date);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_date_time);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_date_timestamp);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_date_timestamp_us);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_date_timestamp_ns);
+ISODATETIME_BENCH_STRING(get_current_iso_date_time_offset);
+ISODATETIME_BENCH_STRING(get_current_iso_date_timestamp_offset);
+ISODATETIME_BENCH_STRING(get_current_iso_week_date);
+ISODATETIME_BENCH_STRING(get_current_iso_ordinal_date);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_week_date);
+ISODATETIME_BENCH_STRING(get_current_utc_iso_ordinal_date);
+
+// ---------- format_current_* ----------
+
+#define ISODATETIME_BENCH_BUFFER(name)                                                                              \
+    BENCHMARK_CAPTURE(BM_buffer_tp, name, [](char* buffer, std::size_t size, const time_point& tp) {               \
+        return ISODateTime::name(buffer, size, tp);                                                                 \
+    })->ThreadRange(1, max_threads());                                                                              \
+    BENCHMARK_CAPTURE(BM_buffer_now, name, [](char* buffer, std::size_t size) {                                    \
+        return ISODateTime::name(buffer, size);                                                                     \
+    })->ThreadRange(1, max_threads())
+
+ISODATETIME_BENCH_BUFFER(format_current_iso_date);
+ISODATETIME_BENCH_BUFFER(format_current_utc_iso_date);
+ISODATETIME_BENCH_BUFFER(format_current_iso_week_date);
+ISODATETIME_BENCH_BUFFER(format_current_iso_ordinal_date);
+ISODATETIME_BENCH_BUFFER(format_current_utc_iso_week_date);
+ISODATETIME_BENCH_BUFFER(format_current_utc_iso_ordinal_date);
+ISODATETIME_BENCH_BUFFER(format_current_iso_date_timestamp);
+ISODATETIME_BENCH_BUFFER(format_current_utc_iso_date_timestamp);
+ISODATETIME_BENCH_BUFFER(format_current_iso_date_time_offset);
+ISODATETIME_BENCH_BUFFER(format_current_iso_date_timestamp_offset);
+
+// ---------- IsoStamp ----------
+
+BENCHMARK_CAPTURE(BM_string_tp, stamp_utc_iso_date_timestamp, [](const time_point& tp) {
+    return ISODateTime::stamp(ISODateTime::Format::utc_iso_date_timestamp, tp);
+})->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_string_now, stamp_utc_iso_date_timestamp, [] {
+    return ISODateTime::stamp(ISODateTime::Format::utc_iso_date_timestamp);
+})->ThreadRange(1, max_threads());
+
+// ---------- Local offset cache ----------
+
+/**
+ * @brief Local timestamps with the cached UTC offset table instead of localtime_r.
+ */
+static void BM_get_current_iso_date_timestamp_tp_offset_cache(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+        ISODateTime::enable_local_offset_cache();
+    BM_string_tp(state, [](const time_point& tp) { return ISODateTime::get_current_iso_date_timestamp(tp); });
+    if (state.thread_index() == 0)
+        ISODateTime::disable_local_offset_cache();
+}
+BENCHMARK(BM_get_current_iso_date_timestamp_tp_offset_cache)->ThreadRange(1, max_threads());
+
+// ---------- Clock sources ----------
+
+/**
+ * @brief No-argument UTC timestamps with each ClockSource.
+ */
+static void BM_format_current_utc_iso_date_timestamp_clock(benchmark::State& state, ISODateTime::ClockSource source)
+{
+    if (state.thread_index() == 0)
+        ISODateTime::set_clock_source(source);
+    BM_buffer_now(state, [](char* buffer, std::size_t size) { return ISODateTime::format_current_utc_iso_date_timestamp(buffer, size); });
+    if (state.thread_index() == 0)
+        ISODateTime::set_clock_source(ISODateTime::ClockSource::system);
+}
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_clock, system, ISODateTime::ClockSource::system)->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_clock, realtime_coarse, ISODateTime::ClockSource::realtime_coarse)->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_clock, tsc, ISODateTime::ClockSource::tsc)->ThreadRange(1, max_threads());
+
+// ---------- Monotonic mode ----------
+
+/**
+ * @brief The bare system_clock::now() read that MonotonicMode::off performs, as the baseline.
+ */
+static void BM_system_clock_now(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::chrono::system_clock::now());
+}
+BENCHMARK(BM_system_clock_now)->ThreadRange(1, max_threads());
+
+/**
+ * @brief No-argument UTC timestamps with each MonotonicMode; global contends on one atomic as threads are added.
+ */
+static void BM_format_current_utc_iso_date_timestamp_monotonic(benchmark::State& state, ISODateTime::MonotonicMode mode)
+{
+    if (state.thread_index() == 0)
+        ISODateTime::set_monotonic_mode(mode);
+    BM_buffer_now(state, [](char* buffer, std::size_t size) { return ISODateTime::format_current_utc_iso_date_timestamp(buffer, size); });
+    if (state.thread_index() == 0)
+        ISODateTime::set_monotonic_mode(ISODateTime::MonotonicMode::off);
+}
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_monotonic, off, ISODateTime::MonotonicMode::off)->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_monotonic, per_thread, ISODateTime::MonotonicMode::per_thread)->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_current_utc_iso_date_timestamp_monotonic, global, ISODateTime::MonotonicMode::global)->ThreadRange(1, max_threads());
+
+// ---------- Ticker ----------
+
+/**
+ * @brief Reading the ticker's published UTC timestamp instead of formatting it.
+ */
+static void BM_format_current_utc_iso_date_timestamp_ticker(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+        ISODateTime::start_ticker(std::chrono::milliseconds(1), true);
+    BM_buffer_now(state, [](char* buffer, std::size_t size) { return ISODateTime::format_current_utc_iso_date_timestamp(buffer, size); });
+    if (state.thread_index() == 0)
+        ISODateTime::stop_ticker();
+}
+BENCHMARK(BM_format_current_utc_iso_date_timestamp_ticker)->ThreadRange(1, max_threads());
+
+// ---------- Time zones ----------
+
+/**
+ * @brief Rendering in a dozen IANA zones in turn, as a multi-region request would.
+ */
+static void BM_format_zoned(benchmark::State& state)
+{
+    static const char* const names[] = {"America/New_York", "America/Chicago", "America/Los_Angeles", "America/Sao_Paulo",
+                                        "Europe/London", "Europe/Paris", "Europe/Moscow", "Asia/Kolkata",
+                                        "Asia/Shanghai", "Asia/Tokyo", "Australia/Sydney", "Pacific/Auckland"};
+    std::vector<ISODateTime::TimeZone> zones;
+    for (const char* name : names)
+        if (const auto zone = ISODateTime::load_zone(name))
+            zones.push_back(*zone);
+    if (zones.empty()) {
+        state.SkipWithError("tzdata not available");
+        return;
+    }
+    char buffer[64];
+    auto tp = start_time;
+    std::size_t next = 0;
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::format(ISODateTime::Format::iso_date_timestamp, zones[next], buffer, sizeof(buffer), tp));
+        benchmark::ClobberMemory();
+        next = next + 1 == zones.size() ? 0 : next + 1;
+        tp = next_time_point(tp);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_format_zoned)->ThreadRange(1, max_threads());
+
+// ---------- Batch formatting ----------
+
+/**
+ * @brief format_batch over sorted time_points one millisecond apart; reports items/s.
+ */
+static void BM_format_batch(benchmark::State& state, ISODateTime::Format format)
+{
+    std::vector<time_point> time_points(4096);
+    for (std::size_t i = 0; i < time_points.size(); ++i)
+        time_points[i] = start_time + std::chrono::milliseconds(i);
+    std::vector<char> buffer(time_points.size() * ISODateTime::formatted_length(format));
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::format_batch(format, time_points.data(), time_points.size(), buffer.data(), buffer.size()));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * time_points.size()));
+}
+BENCHMARK_CAPTURE(BM_format_batch, iso_date_timestamp, ISODateTime::Format::iso_date_timestamp);
+BENCHMARK_CAPTURE(BM_format_batch, utc_iso_date_timestamp, ISODateTime::Format::utc_iso_date_timestamp);
+
+/**
+ * @brief format_batch_parallel over 4M time_points one microsecond apart; reports items/s. Arg is the thread count.
+ */
+static void BM_format_batch_parallel(benchmark::State& state, ISODateTime::Format format)
+{
+    std::vector<time_point> time_points(std::size_t{1} << 22);
+    for (std::size_t i = 0; i < time_points.size(); ++i)
+        time_points[i] = start_time + std::chrono::microseconds(i);
+    std::vector<char> buffer(time_points.size() * ISODateTime::formatted_length(format));
+    const auto threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::format_batch_parallel(format, time_points.data(), time_points.size(), buffer.data(), buffer.size(), threads));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * time_points.size()));
+}
+BENCHMARK_CAPTURE(BM_format_batch_parallel, utc_iso_date_timestamp, ISODateTime::Format::utc_iso_date_timestamp)
+    ->RangeMultiplier(2)->Range(1, max_threads())->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ---------- Format plans ----------
+
+/**
+ * @brief Custom patterns through a compiled FormatPlan, for comparison with the built-in formats.
+ */
+static void BM_format_plan(benchmark::State& state, const char* pattern)
+{
+    const auto plan = ISODateTime::compile_format(pattern).value();
+    BM_buffer_tp(state, [&plan](char* buffer, std::size_t size, const time_point& tp) { return ISODateTime::format(plan, buffer, size, tp); });
+}
+BENCHMARK_CAPTURE(BM_format_plan, compact_date_time, "%Y%m%dT%H%M%S")->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_plan, space_comma_millis, "%F %T,%3N")->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_format_plan, iso_date_timestamp, "%FT%T.%3N")->ThreadRange(1, max_threads());
+
+// ---------- fmt formatter ----------
+
+#if defined(ISODATETIME_BENCH_FMT)
+/**
+ * @brief Appending a UTC timestamp to a fmt::memory_buffer, as a logger would.
+ */
+template <typename Function>
+static void BM_fmt_append(benchmark::State& state, Function function)
+{
+    fmt::memory_buffer buffer;
+    auto tp = start_time;
+    const auto before = allocations;
+    for (auto _ : state) {
+        buffer.clear();
+        function(buffer, tp);
+        benchmark::DoNotOptimize(buffer.data());
+        tp = next_time_point(tp);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK_CAPTURE(BM_fmt_append, formatter, [](fmt::memory_buffer& buffer, const time_point& tp) {
+    fmt::format_to(std::back_inserter(buffer), "{:utc_timestamp}", ISODateTime::IsoTime{tp});
+});
+BENCHMARK_CAPTURE(BM_fmt_append, via_string, [](fmt::memory_buffer& buffer, const time_point& tp) {
+    fmt::format_to(std::back_inserter(buffer), "{}", ISODateTime::get_current_utc_iso_date_timestamp(tp));
+});
+#endif
+
+// ---------- Compact times ----------
+
+BENCHMARK_CAPTURE(BM_string_now, capture_compact, [] { return ISODateTime::capture_compact(); })->ThreadRange(1, max_threads());
+
+/**
+ * @brief format_compact_batch over captures one millisecond apart; reports items/s.
+ */
+static void BM_format_compact_batch(benchmark::State& state, ISODateTime::Format format)
+{
+    std::vector<ISODateTime::CompactTime> times(4096);
+    for (std::size_t i = 0; i < times.size(); ++i)
+        times[i] = ISODateTime::capture_compact(start_time + std::chrono::milliseconds(i));
+    std::vector<char> buffer(times.size() * ISODateTime::formatted_length(format));
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::format_compact_batch(format, times.data(), times.size(), buffer.data(), buffer.size()));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * times.size()));
+}
+BENCHMARK_CAPTURE(BM_format_compact_batch, iso_date_timestamp_offset, ISODateTime::Format::iso_date_timestamp_offset);
+BENCHMARK_CAPTURE(BM_format_compact_batch, utc_iso_date_timestamp, ISODateTime::Format::utc_iso_date_timestamp);
+
+// ---------- Deferred stamps ----------
+
+BENCHMARK_CAPTURE(BM_string_now, capture_utc_iso_date_timestamp, [] {
+    return ISODateTime::capture(ISODateTime::Format::utc_iso_date_timestamp);
+})->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(BM_buffer_tp, format_deferred_utc_iso_date_timestamp, [](char* buffer, std::size_t size, const time_point& tp) {
+    return ISODateTime::format(ISODateTime::DeferredStamp{tp, ISODateTime::Format::utc_iso_date_timestamp}, buffer, size);
+})->ThreadRange(1, max_threads());
+
+// ---------- Parsing ----------
+
+/**
+ * @brief Round-trip parse of get_current_utc_iso_date_timestamp output.
+ */
+static void BM_parse_utc_iso(benchmark::State& state)
+{
+    const auto text = ISODateTime::get_current_utc_iso_date_timestamp(start_time);
+    const auto before = allocations;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ISODateTime::parse_utc_iso(text));
+    report_allocations(state, before);
+}
+BENCHMARK(BM_parse_utc_iso);
+
+/**
+ * @brief Local-time parse of get_current_iso_date_timestamp output.
+ */
+static void BM_parse_iso(benchmark::State& state)
+{
+    const auto text = ISODateTime::get_current_iso_date_timestamp(start_time);
+    const auto before = allocations;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ISODateTime::parse_iso(text));
+    report_allocations(state, before);
+}
+BENCHMARK(BM_parse_iso);
+
+/**
+ * @brief Batch parse of fixed-width UTC timestamps; reports items/s.
+ */
+static void BM_parse_utc_iso_timestamps(benchmark::State& state)
+{
+    constexpr std::size_t count = 4096;
+    constexpr std::size_t stride = ISODateTime::utc_iso_date_timestamp_length;
+    std::vector<char> records(count * stride);
+    for (std::size_t i = 0; i < count; ++i)
+        (void)ISODateTime::format_current_utc_iso_date_timestamp(records.data() + i * stride, stride, start_time + std::chrono::milliseconds(i * 7));
+    std::vector<std::optional<time_point>> results(count);
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::parse_utc_iso_timestamps(records.data(), stride, count, results.data()));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_parse_utc_iso_timestamps);
+
+// ---------- Log rewriting ----------
+
+/**
+ * @brief rewrite_log_timestamps over a 32 MiB generated log (local millisecond timestamps, ~20 lines per
+ *        second) on 1..N threads; reports bytes/s. Arg is the thread count.
+ */
+static void BM_rewrite_log_timestamps(benchmark::State& state)
+{
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string input = (directory / "ISODateTime_bench_log_in.txt").string();
+    const std::string output = (directory / "ISODateTime_bench_log_out.txt").string();
+    std::string text;
+    for (std::size_t i = 0; text.size() < (std::size_t{32} << 20); ++i)
+        text += ISODateTime::get_current_iso_date_timestamp(start_time + std::chrono::milliseconds(i * 50)) + " INFO [worker-3] request handled status=200\n";
+    if (std::FILE* file = std::fopen(input.c_str(), "wb")) {
+        std::fwrite(text.data(), 1, text.size(), file);
+        std::fclose(file);
+    }
+    const ISODateTime::LogRewriteOptions options{ISODateTime::scan_for_timestamp, static_cast<unsigned>(state.range(0)), 0};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ISODateTime::rewrite_log_timestamps(input, output, options));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+BENCHMARK(BM_rewrite_log_timestamps)->RangeMultiplier(2)->Range(1, max_threads())->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ---------- Sortable keys ----------
+
+/**
+ * @brief sortable_keys over fixed-width records of a Format; reports items/s. Compare with BM_parse_utc_iso_timestamps.
+ */
+static void BM_sortable_keys(benchmark::State& state, ISODateTime::Format format)
+{
+    constexpr std::size_t count = 4096;
+    const std::size_t length = ISODateTime::formatted_length(format);
+    std::vector<char> records(count * length);
+    for (std::size_t i = 0; i < count; ++i)
+        (void)ISODateTime::format(format, records.data() + i * length, length, start_time + std::chrono::milliseconds(i * 7));
+    std::vector<std::uint64_t> keys(count);
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::sortable_keys(records.data(), length, length, count, keys.data()));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+BENCHMARK_CAPTURE(BM_sortable_keys, utc_iso_date_timestamp, ISODateTime::Format::utc_iso_date_timestamp);
+BENCHMARK_CAPTURE(BM_sortable_keys, iso_date_timestamp_offset, ISODateTime::Format::iso_date_timestamp_offset);
+
+// ---------- Durations ----------
+
+/**
+ * @brief format_iso_duration over latencies from a few nanoseconds to a few days.
+ */
+static void BM_format_iso_duration(benchmark::State& state)
+{
+    std::vector<std::chrono::nanoseconds> durations(1024);
+    std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto& duration : durations) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        duration = std::chrono::nanoseconds(static_cast<std::int64_t>((seed >> 11) >> (seed % 40)));
+    }
+    char buffer[ISODateTime::iso_duration_max_length];
+    std::size_t i = 0;
+    const auto before = allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ISODateTime::format_iso_duration(buffer, sizeof(buffer), durations[i++ % durations.size()]));
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_format_iso_duration);
+
+/**
+ * @brief parse_iso_duration of a typical latency.
+ */
+static void BM_parse_iso_duration(benchmark::State& state)
+{
+    const std::string text = ISODateTime::get_iso_duration(std::chrono::microseconds(1234567));
+    const auto before = allocations;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ISODateTime::parse_iso_duration(text));
+    report_allocations(state, before);
+}
+BENCHMARK(BM_parse_iso_duration);
@@ -0,0 +1,273 @@
+//
+// Thread-scaling stress test for ISODateTime.
+//
+// Build with -DISODATETIME_BUILD_STRESS=ON and run
+//     ISODateTime_stress [seconds per run, default 1] [max threads, default hardware_concurrency]
+// Each case hammers one get_current_* function from 1, 2, 4, ... threads up to the maximum and
+// prints total and per-thread throughput with p50/p99/p999/max latency from a log-linear
+// histogram. The *_tp cases pass a time_point that advances by a little over one second per
+// call, so every call misses the per-thread seconds cache and pays for the tm conversion (the
+// localtime_r / tz lock path for local time). A final breakdown times the tm conversion and
+// the digit formatting separately to show where the time goes as threads are added.
+//
+// Latencies include two steady_clock reads; the timer overhead printed first is the floor.
+//
+
+#include "ISODateTime.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using stress_clock = std::chrono::steady_clock;
+
+// ---------- Latency histogram ----------
+
+/**
+ * @brief Log-linear latency histogram: 8 linear sub-buckets per power of two (12.5% resolution).
+ */
+class latency_histogram {
+    static constexpr unsigned sub_bits = 3;
+    static constexpr unsigned sub_buckets = 1U << sub_bits;
+
+public:
+    void record(std::uint64_t nanoseconds) noexcept
+    {
+        ++counts_[bucket_of(nanoseconds)];
+        ++total_;
+        max_ = std::max(max_, nanoseconds);
+    }
+
+    void merge(const latency_histogram& other) noexcept
+    {
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+            counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    /**
+     * @brief Lower bound of the bucket holding the given quantile (0-1), in nanoseconds.
+     */
+    std::uint64_t quantile(double q) const noexcept
+    {
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total_));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen > rank)
+                return lower_bound_of(i);
+        }
+        return max_;
+    }
+
+    std::uint64_t total() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+private:
+    static std::size_t bucket_of(std::uint64_t value) noexcept
+    {
+        if (value < sub_buckets)
+            return static_cast<std::size_t>(value);
+        unsigned msb = 0;
+        while ((value >> (msb + 1)) != 0)
+            ++msb;
+        const unsigned shift = msb - sub_bits;
+        return (static_cast<std::size_t>(shift + 1) << sub_bits) + static_cast<std::size_t>((value >> shift) & (sub_buckets - 1));
+    }
+
+    static std::uint64_t lower_bound_of(std::size_t bucket) noexcept
+    {
+        const std::size_t group = bucket >> sub_bits;
+        if (group == 0)
+            return bucket;
+        return static_cast<std::uint64_t>(sub_buckets + (bucket & (sub_buckets - 1))) << (group - 1);
+    }
+
+    std::array<std::uint64_t, (64 - sub_bits + 1) << sub_bits> counts_{};
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+// ---------- Runner ----------
+
+/**
+ * @brief One function under test; the time_point is ignored by the *_now cases.
+ */
+struct stress_case {
+    const char* name;
+    std::size_t (*call)(const time_point&);
+    bool offset_cache; // run with enable_local_offset_cache()
+};
+
+static const stress_case cases[] = {
+    {"local_tp", [](const time_point& tp) { return ISODateTime::get_current_iso_date_timestamp(tp).size(); }, false},
+    {"utc_tp", [](const time_point& tp) { return ISODateTime::get_current_utc_iso_date_timestamp(tp).size(); }, false},
+    {"local_tp_offset_cache", [](const time_point& tp) { return ISODateTime::get_current_iso_date_timestamp(tp).size(); }, true},
+    {"local_now", [](const time_point&) { return ISODateTime::get_current_iso_date_timestamp().size(); }, false},
+    {"utc_now", [](const time_point&) { return ISODateTime::get_current_utc_iso_date_timestamp().size(); }, false},
+};
+
+static constexpr auto time_step = std::chrono::milliseconds(1001);
+
+/**
+ * @brief Start all workers together and stop them together after the run time.
+ */
+struct run_control {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+};
+
+/**
+ * @brief Per-thread results of one run.
+ */
+struct worker_result {
+    latency_histogram latency;
+    std::uint64_t checksum = 0; // keeps the calls observable
+    // Breakdown runs only
+    std::uint64_t convert_ns = 0;
+    std::uint64_t format_ns = 0;
+};
+
+/**
+ * @brief Spawn threads running body(index, control, result) and return their results once the run time has passed.
+ */
+template <typename Body>
+static std::vector<worker_result> run_threads(unsigned threads, double seconds, Body body)
+{
+    run_control control;
+    std::vector<worker_result> results(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back([&, i] {
+            control.ready.fetch_add(1);
+            while (!control.go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            body(i, control, results[i]);
+        });
+    while (control.ready.load() != threads)
+        std::this_thread::yield();
+    control.go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    control.stop.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers)
+        worker.join();
+    return results;
+}
+
+/**
+ * @brief Time every call of one case on every thread.
+ */
+static void run_case(const stress_case& test, unsigned threads, double seconds)
+{
+    if (test.offset_cache)
+        ISODateTime::enable_local_offset_cache();
+    const auto start_time = std::chrono::system_clock::now();
+    const auto results = run_threads(threads, seconds, [&](unsigned index, const run_control& control, worker_result& result) {
+        // Threads walk different hours so they never share a second
+        auto tp = start_time + std::chrono::hours(index);
+        while (!control.stop.load(std::memory_order_relaxed)) {
+            const auto before = stress_clock::now();
+            result.checksum += test.call(tp);
+            const auto after = stress_clock::now();
+            result.latency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+            tp += time_step;
+        }
+    });
+    if (test.offset_cache)
+        ISODateTime::disable_local_offset_cache();
+
+    latency_histogram latency;
+    for (const auto& result : results)
+        latency.merge(result.latency);
+    const double calls_per_second = static_cast<double>(latency.total()) / seconds;
+    std::printf("%-22s %7u %12.3f %12.3f %8llu %8llu %8llu %10llu\n", test.name, threads, calls_per_second / 1e6, calls_per_second / 1e6 / threads,
+                static_cast<unsigned long long>(latency.quantile(0.5)), static_cast<unsigned long long>(latency.quantile(0.99)),
+                static_cast<unsigned long long>(latency.quantile(0.999)), static_cast<unsigned long long>(latency.max()));
+}
+
+/**
+ * @brief Split the uncached local and UTC paths into tm conversion and digit formatting.
+ */
+static void run_breakdown(bool utc, unsigned threads, double seconds)
+{
+    const auto start_time = std::chrono::system_clock::now();
+    const auto results = run_threads(threads, seconds, [&](unsigned index, const run_control& control, worker_result& result) {
+        auto t = std::chrono::system_clock::to_time_t(start_time + std::chrono::hours(index));
+        char buffer[ISODateTime::utc_iso_date_timestamp_length];
+        while (!control.stop.load(std::memory_order_relaxed)) {
+            const auto before = stress_clock::now();
+            const std::tm tm = utc ? isodatetime_detail::to_utc_tm(t) : isodatetime_detail::to_local_tm(t);
+            const auto converted = stress_clock::now();
+            result.checksum += isodatetime_detail::write_iso_text(buffer, sizeof(buffer), tm, true, 3, 0, utc);
+            const auto formatted = stress_clock::now();
+            result.convert_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(converted - before).count());
+            result.format_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(formatted - converted).count());
+            result.latency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(formatted - before).count()));
+            ++t;
+        }
+    });
+
+    std::uint64_t convert_ns = 0;
+    std::uint64_t format_ns = 0;
+    latency_histogram latency;
+    for (const auto& result : results) {
+        convert_ns += result.convert_ns;
+        format_ns += result.format_ns;
+        latency.merge(result.latency);
+    }
+    const double calls = static_cast<double>(std::max<std::uint64_t>(latency.total(), 1));
+    const double total_ns = static_cast<double>(std::max<std::uint64_t>(convert_ns + format_ns, 1));
+    std::printf("%-22s %7u %12.1f %12.1f %11.1f%% %11.1f%%\n", utc ? "to_utc_tm + format" : "to_local_tm + format", threads,
+                static_cast<double>(convert_ns) / calls, static_cast<double>(format_ns) / calls,
+                100.0 * static_cast<double>(convert_ns) / total_ns, 100.0 * static_cast<double>(format_ns) / total_ns);
+}
+
+/**
+ * @brief 1, 2, 4, ... up to and including max_threads.
+ */
+static std::vector<unsigned> thread_counts(unsigned max_threads)
+{
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(0.01, std::strtod(argv[1], nullptr)) : 1.0;
+    const unsigned hardware = std::max(1U, std::thread::hardware_concurrency());
+    const unsigned max_threads = argc > 2 ? std::max(1U, static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))) : hardware;
+
+    latency_histogram timer;
+    for (int i = 0; i < 100000; ++i) {
+        const auto before = stress_clock::now();
+        const auto after = stress_clock::now();
+        timer.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+    }
+    std::printf("timer overhead p50 %llu ns; %.2f s per run; up to %u threads\n\n", static_cast<unsigned long long>(timer.quantile(0.5)), seconds, max_threads);
+
+    std::printf("%-22s %7s %12s %12s %8s %8s %8s %10s\n", "case", "threads", "Mcalls/s", "Mcalls/s/thr", "p50 ns", "p99 ns", "p999 ns", "max ns");
+    for (const auto& test : cases) {
+        for (const unsigned threads : thread_counts(max_threads))
+            run_case(test, threads, seconds);
+    }
+
+    std::printf("\n%-22s %7s %12s %12s %12s %12s\n", "breakdown", "threads", "convert ns", "format ns", "convert", "format");
+    for (const bool utc : {false, true}) {
+        for (const unsigned threads : thread_counts(max_threads))
+            run_breakdown(utc, threads, seconds);
+    }
+    return 0;
+}
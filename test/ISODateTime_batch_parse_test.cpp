@@ -0,0 +1,158 @@
+//
+// parse_utc_iso_timestamps and its SIMD kernels against the scalar path.
+//
+// Valid bodies and bodies with one byte replaced are fed to every kernel the build has; each
+// must agree with read_timestamp_body_scalar on both the verdict and the fields. The batch
+// parser must give the same result per record as parse_utc_iso.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+
+namespace {
+
+/**
+ * @brief Random utc_iso_date_timestamp records, some with one byte replaced.
+ */
+class random_records {
+public:
+    explicit random_records(std::uint64_t seed) : engine_(seed) {}
+
+    std::string valid()
+    {
+        // 1678-01-01 to 2261-12-31, clear of the clock's limits
+        std::uniform_int_distribution<std::int64_t> seconds(-9214646400LL, 9214559999LL);
+        std::uniform_int_distribution<int> milliseconds(0, 999);
+        const time_point t(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(seconds(engine_)) + std::chrono::milliseconds(milliseconds(engine_))));
+        char buffer[32];
+        return {buffer, ISODateTime::format(Format::utc_iso_date_timestamp, buffer, sizeof(buffer), t)};
+    }
+
+    std::string mutated()
+    {
+        // Out-of-range digits are mostly still digits, so half the replacements are digits
+        std::string record = valid();
+        std::uniform_int_distribution<std::size_t> position(0, record.size() - 1);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::uniform_int_distribution<int> digit('0', '9');
+        const std::size_t i = position(engine_);
+        record[i] = static_cast<char>(engine_() % 2 ? byte(engine_) : digit(engine_));
+        return record;
+    }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+using kernel_list = std::vector<std::pair<const char*, isodatetime_detail::timestamp_body_kernel>>;
+
+/**
+ * @brief The kernels to check against the scalar path: the dispatched one and each SIMD one the CPU runs.
+ */
+kernel_list simd_kernels()
+{
+    kernel_list kernels{{"dispatched", isodatetime_detail::get_timestamp_body_kernel()}};
+#if defined(ISODATETIME_X86)
+    if (isodatetime_detail::cpu_has_ssse3())
+        kernels.emplace_back("ssse3", &isodatetime_detail::read_timestamp_body_ssse3);
+#elif defined(ISODATETIME_NEON)
+    kernels.emplace_back("neon", &isodatetime_detail::read_timestamp_body_neon);
+#endif
+    return kernels;
+}
+
+void expect_same_as_scalar(const std::string& record)
+{
+    isodatetime_detail::parsed_fields expected{};
+    const bool expected_ok = isodatetime_detail::read_timestamp_body_scalar(record.data(), expected);
+    for (const auto& [name, kernel] : simd_kernels()) {
+        isodatetime_detail::parsed_fields fields{};
+        const bool ok = kernel(record.data(), fields);
+        ASSERT_EQ(ok, expected_ok) << name << " on \"" << record << '"';
+        if (!ok)
+            continue;
+        EXPECT_EQ(fields.year, expected.year) << name << " on " << record;
+        EXPECT_EQ(fields.month, expected.month) << name << " on " << record;
+        EXPECT_EQ(fields.day, expected.day) << name << " on " << record;
+        EXPECT_EQ(fields.hour, expected.hour) << name << " on " << record;
+        EXPECT_EQ(fields.minute, expected.minute) << name << " on " << record;
+        EXPECT_EQ(fields.second, expected.second) << name << " on " << record;
+        EXPECT_EQ(fields.nanoseconds, expected.nanoseconds) << name << " on " << record;
+    }
+}
+
+} // namespace
+
+TEST(BatchParseKernels, MatchScalarOnValidBodies)
+{
+    random_records records(1);
+    for (int i = 0; i < 20000; ++i)
+        expect_same_as_scalar(records.valid());
+    // Digit extremes the random times do not reach
+    expect_same_as_scalar("0000-00-00T00:00:00.000Z");
+    expect_same_as_scalar("9999-99-99T99:99:99.999Z");
+}
+
+TEST(BatchParseKernels, MatchScalarOnMutatedBodies)
+{
+    random_records records(2);
+    for (int i = 0; i < 50000; ++i)
+        expect_same_as_scalar(records.mutated());
+    // Every separator position replaced by a digit, and every digit by each neighbour of '0'..'9'
+    const std::string valid = "2024-02-29T23:59:59.999Z";
+    for (std::size_t i = 0; i < 23; ++i) {
+        for (const char replacement : {'/', ':', '0', '9', ' ', '\0', '\x80', '\xff'}) {
+            std::string record = valid;
+            record[i] = replacement;
+            expect_same_as_scalar(record);
+        }
+    }
+}
+
+TEST(BatchParse, MatchesParseUtcIsoPerRecord)
+{
+    // Newline-separated records, as in a log file, so the stride is one more than the record
+    random_records records(3);
+    constexpr std::size_t stride = ISODateTime::utc_iso_date_timestamp_length + 1;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 10000; ++i)
+        texts.push_back(i % 3 == 0 ? records.mutated() : records.valid());
+    for (const char* text : {"2023-02-29T00:00:00.000Z", "2024-13-01T00:00:00.000Z", "2024-01-01T24:00:00.000Z",
+                             "2024-01-01T00:00:00.000+", "1600-01-01T00:00:00.000Z", "9999-12-31T23:59:59.999Z"})
+        texts.emplace_back(text);
+    std::string buffer;
+    for (const auto& text : texts)
+        buffer += text + '\n';
+
+    std::vector<std::optional<time_point>> results(texts.size());
+    const std::size_t parsed = ISODateTime::parse_utc_iso_timestamps(buffer.data(), stride, texts.size(), results.data());
+    std::size_t expected_parsed = 0;
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+        const auto expected = ISODateTime::parse_utc_iso(texts[i]);
+        EXPECT_EQ(results[i], expected) << '"' << texts[i] << '"';
+        expected_parsed += expected.has_value();
+    }
+    EXPECT_EQ(parsed, expected_parsed);
+}
+
+TEST(BatchParse, RejectsBadArguments)
+{
+    const std::string record = "2024-01-01T00:00:00.000Z";
+    std::optional<time_point> result;
+    EXPECT_EQ(ISODateTime::parse_utc_iso_timestamps(nullptr, record.size(), 1, &result), 0U);
+    EXPECT_EQ(ISODateTime::parse_utc_iso_timestamps(record.data(), record.size(), 1, nullptr), 0U);
+    EXPECT_EQ(ISODateTime::parse_utc_iso_timestamps(record.data(), record.size() - 1, 1, &result), 0U);
+    EXPECT_EQ(ISODateTime::parse_utc_iso_timestamps(record.data(), record.size(), 0, &result), 0U);
+    EXPECT_EQ(ISODateTime::parse_utc_iso_timestamps(record.data(), record.size(), 1, &result), 1U);
+    EXPECT_EQ(result, ISODateTime::parse_utc_iso(record));
+}
@@ -0,0 +1,87 @@
+//
+// set_clock_source: fallbacks, and readings through each source next to system_clock.
+//
+// Every ClockSource is selected in turn. get_clock_source must report it, or system where the
+// platform or CPU lacks it, and the no-argument functions must then read a time within a few
+// milliseconds of system_clock::now() taken around the call.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using ClockSource = ISODateTime::ClockSource;
+
+namespace {
+
+/**
+ * @brief Select a clock source for the duration of a test, and system again afterwards.
+ */
+class scoped_clock_source {
+public:
+    explicit scoped_clock_source(ClockSource source) { ISODateTime::set_clock_source(source); }
+    ~scoped_clock_source() { ISODateTime::set_clock_source(ClockSource::system); }
+    scoped_clock_source(const scoped_clock_source&) = delete;
+    scoped_clock_source& operator=(const scoped_clock_source&) = delete;
+};
+
+/**
+ * @brief Read the selected source through get_current_utc_iso_date_timestamp_ns and check it
+ *        against system_clock readings taken before and after.
+ * @param slack Allowed distance outside [before, after].
+ */
+void expect_reads_near_system_clock(std::chrono::nanoseconds slack)
+{
+    for (int i = 0; i < 1000; ++i) {
+        const auto before = std::chrono::system_clock::now();
+        const std::string text = ISODateTime::get_current_utc_iso_date_timestamp_ns();
+        const auto after = std::chrono::system_clock::now();
+        const auto read = ISODateTime::parse_utc_iso(text);
+        ASSERT_TRUE(read.has_value()) << text;
+        EXPECT_GE(*read, before - slack) << text;
+        EXPECT_LE(*read, after + slack) << text;
+    }
+}
+
+} // namespace
+
+TEST(ClockSource, SystemIsTheDefault)
+{
+    EXPECT_EQ(ISODateTime::get_clock_source(), ClockSource::system);
+    expect_reads_near_system_clock(std::chrono::microseconds(1));
+}
+
+TEST(ClockSource, RealtimeCoarseIsWithinATick)
+{
+    const scoped_clock_source source(ClockSource::realtime_coarse);
+#if defined(__linux__)
+    EXPECT_EQ(ISODateTime::get_clock_source(), ClockSource::realtime_coarse);
+#else
+    EXPECT_EQ(ISODateTime::get_clock_source(), ClockSource::system);
+#endif
+    // The kernel tick is 1-4 ms, and the coarse clock lags by up to one of them
+    expect_reads_near_system_clock(std::chrono::milliseconds(10));
+}
+
+TEST(ClockSource, TscTracksSystemClockOrFallsBack)
+{
+    const scoped_clock_source source(ClockSource::tsc);
+    const auto effective = ISODateTime::get_clock_source();
+    EXPECT_TRUE(effective == ClockSource::tsc || effective == ClockSource::system);
+#if !defined(ISODATETIME_X86)
+    EXPECT_EQ(effective, ClockSource::system);
+#endif
+    // Calibration error builds up for at most a second between re-anchors
+    expect_reads_near_system_clock(std::chrono::milliseconds(5));
+}
+
+TEST(ClockSource, ExplicitTimePointsIgnoreTheSource)
+{
+    const time_point t(std::chrono::seconds(1700000000));
+    for (const ClockSource source : {ClockSource::system, ClockSource::realtime_coarse, ClockSource::tsc}) {
+        const scoped_clock_source selected(source);
+        EXPECT_EQ(ISODateTime::get_current_utc_iso_date_timestamp_ns(t), "2023-11-14T22:13:20.000000000Z");
+    }
+}
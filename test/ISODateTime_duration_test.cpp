@@ -0,0 +1,202 @@
+//
+// ISO 8601 durations and intervals: format, parse and the round trip between them.
+//
+// Random nanosecond counts over the whole int64 range, and both ends of it, must parse back
+// from their formatted text exactly. Specific spellings check the shortest form written and the
+// alternatives accepted; years, months and malformed text must be rejected. Intervals are
+// checked in all three of start/end, start/duration and duration/end.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+using std::chrono::nanoseconds;
+
+namespace {
+
+constexpr std::int64_t second = 1000000000;
+constexpr std::int64_t minute = 60 * second;
+constexpr std::int64_t hour = 60 * minute;
+constexpr std::int64_t day = 24 * hour;
+
+time_point utc(const char* text)
+{
+    return ISODateTime::parse_utc_iso(text).value();
+}
+
+} // namespace
+
+TEST(Duration, RandomValuesRoundTrip)
+{
+    std::mt19937_64 engine(1);
+    for (int i = 0; i < 100000; ++i) {
+        // Full range, and values rounded to a unit so zero parts are left out
+        auto value = static_cast<std::int64_t>(engine());
+        constexpr std::int64_t units[] = {1, 1000, 1000000, second, minute, hour, day};
+        if (i % 2 == 1)
+            value = value % (1000 * day) / units[i / 2 % 7] * units[i / 2 % 7];
+        const std::string text = ISODateTime::get_iso_duration(nanoseconds(value));
+        ASSERT_LE(text.size(), ISODateTime::iso_duration_max_length);
+        EXPECT_EQ(ISODateTime::parse_iso_duration(text), nanoseconds(value)) << text;
+    }
+}
+
+TEST(Duration, Bounds)
+{
+    constexpr auto lowest = std::numeric_limits<std::int64_t>::min();
+    constexpr auto highest = std::numeric_limits<std::int64_t>::max();
+    EXPECT_EQ(ISODateTime::get_iso_duration(nanoseconds(highest)), "P106751DT23H47M16.854775807S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(nanoseconds(lowest)), "-P106751DT23H47M16.854775808S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(nanoseconds(lowest)).size(), ISODateTime::iso_duration_max_length);
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P106751DT23H47M16.854775807S"), nanoseconds(highest));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("-P106751DT23H47M16.854775808S"), nanoseconds(lowest));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("-PT9223372036.854775808S"), nanoseconds(lowest));
+    // One past either end, and counts too large for any unit
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("P106751DT23H47M16.854775808S"));
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("-P106751DT23H47M16.854775809S"));
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("PT9223372037S"));
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("P15251W"));
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("P99999999999999999999D"));
+    EXPECT_FALSE(ISODateTime::parse_iso_duration("PT184467440737095516160S"));
+}
+
+TEST(Duration, ShortestFormIsWritten)
+{
+    EXPECT_EQ(ISODateTime::get_iso_duration(nanoseconds(0)), "PT0S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(nanoseconds(1)), "PT0.000000001S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::microseconds(1500)), "PT0.0015S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(-(std::chrono::hours(24) + std::chrono::hours(2))), "-P1DT2H");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::hours(24 * 7)), "P7D");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::seconds(90061)), "P1DT1H1M1S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::minutes(-5)), "-PT5M");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::hours(24) + nanoseconds(100000000)), "P1DT0.1S");
+    EXPECT_EQ(ISODateTime::get_iso_duration(std::chrono::hours(1) + std::chrono::seconds(1)), "PT1H1S");
+}
+
+TEST(Duration, AcceptedSpellings)
+{
+    EXPECT_EQ(ISODateTime::parse_iso_duration("PT0.0015S"), std::chrono::microseconds(1500));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("-P1DT2H"), -std::chrono::hours(26));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P1W"), std::chrono::hours(24 * 7));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P2W3D"), std::chrono::hours(24 * 17));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("+PT1H"), std::chrono::hours(1));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("-PT0S"), nanoseconds(0));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("PT36H"), std::chrono::hours(36));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("PT1,5S"), std::chrono::milliseconds(1500));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("PT1.5M"), std::chrono::seconds(90));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P0.5D"), std::chrono::hours(12));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P0.5W"), std::chrono::hours(84));
+    EXPECT_EQ(ISODateTime::parse_iso_duration("P1DT0S"), std::chrono::hours(24));
+    // Digits past the ninth are dropped
+    EXPECT_EQ(ISODateTime::parse_iso_duration("PT0.0000000019S"), nanoseconds(1));
+}
+
+TEST(Duration, RejectsMalformedText)
+{
+    for (const char* text : {"", "P", "PT", "-P", "1D", "p1D", "P1Y", "P1M", "P1Y2M3D", "PT1Y", "P1DT", "P1D T1H",
+                             "PT1S1M", "PT1H1H", "P1D2W", "P1W1W", "PT1.5H30M", "PT.5S", "PT1.S", "P-1D", "PT-1S",
+                             "PT1s", "P1DT1H ", " P1D", "--P1D", "+-P1D", "P1T1H", "P1H", "PT1D", "PT1W", "P1", "PT1",
+                             "P1.5", "P1DD", "PTT1H", "P1D1D", "PT1e3S", "P1DT1H/"}) {
+        EXPECT_FALSE(ISODateTime::parse_iso_duration(text)) << '"' << text << '"';
+    }
+}
+
+TEST(Duration, ShortBufferIsLeftUntouched)
+{
+    char buffer[ISODateTime::iso_duration_max_length + 1];
+    std::memset(buffer, '#', sizeof(buffer));
+    const nanoseconds value = std::chrono::seconds(90061);
+    EXPECT_EQ(ISODateTime::format_iso_duration(buffer, 9, value), 0U);
+    EXPECT_EQ(std::string(buffer, sizeof(buffer)), std::string(sizeof(buffer), '#'));
+    EXPECT_EQ(ISODateTime::format_iso_duration(buffer, 10, value), 10U);
+    EXPECT_EQ(std::string(buffer, 11), "P1DT1H1M1S#");
+    EXPECT_EQ(ISODateTime::format_iso_duration(nullptr, 64, value), 0U);
+}
+
+TEST(Interval, RandomIntervalsRoundTrip)
+{
+    std::mt19937_64 engine(2);
+    // 1678 to 2261, clear of the clock's limits
+    std::uniform_int_distribution<std::int64_t> seconds(-9214646400LL, 9214559999LL);
+    for (int i = 0; i < 20000; ++i) {
+        const time_point start(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(seconds(engine)) + nanoseconds(engine() % second)));
+        const time_point end(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(seconds(engine)) + nanoseconds(engine() % second)));
+        const std::string text = ISODateTime::get_iso_interval(Format::utc_iso_date_timestamp_ns, {start, end});
+        ASSERT_EQ(text.size(), 2 * ISODateTime::utc_iso_date_timestamp_ns_length + 1);
+        const auto parsed = ISODateTime::parse_iso_interval(text);
+        ASSERT_TRUE(parsed.has_value()) << text;
+        EXPECT_EQ(parsed->start, start) << text;
+        EXPECT_EQ(parsed->end, end) << text;
+
+        // A second interval as start/duration and duration/end, up to 50000 days long either way
+        const nanoseconds length(static_cast<std::int64_t>(engine() % static_cast<std::uint64_t>(100000 * day)) - 50000 * day);
+        constexpr auto lowest = std::chrono::duration_cast<std::chrono::seconds>(time_point::duration::min()).count();
+        constexpr auto highest = std::chrono::duration_cast<std::chrono::seconds>(time_point::duration::max()).count();
+        const auto end_seconds = std::chrono::floor<std::chrono::seconds>(start).time_since_epoch().count() + length.count() / second;
+        if (end_seconds <= lowest + 1 || end_seconds >= highest - 1)
+            continue;
+        const time_point later = start + std::chrono::duration_cast<time_point::duration>(length);
+        const std::string start_text = ISODateTime::get_current_utc_iso_date_timestamp_ns(start);
+        const std::string end_text = ISODateTime::get_current_utc_iso_date_timestamp_ns(later);
+        const std::string duration = ISODateTime::get_iso_duration(length);
+        const auto forward = ISODateTime::parse_iso_interval(start_text + '/' + duration);
+        const auto backward = ISODateTime::parse_iso_interval(duration + '/' + end_text);
+        ASSERT_TRUE(forward && backward) << start_text << ' ' << duration << ' ' << end_text;
+        EXPECT_EQ(forward->start, start);
+        EXPECT_EQ(forward->end, later);
+        EXPECT_EQ(backward->start, start);
+        EXPECT_EQ(backward->end, later);
+    }
+}
+
+TEST(Interval, Forms)
+{
+    const auto check = [](const char* text, const char* start, const char* end) {
+        const auto interval = ISODateTime::parse_iso_interval(text);
+        ASSERT_TRUE(interval.has_value()) << text;
+        EXPECT_EQ(interval->start, utc(start)) << text;
+        EXPECT_EQ(interval->end, utc(end)) << text;
+    };
+    check("2024-01-01T00:00:00Z/2024-01-02T12:00:00Z", "2024-01-01T00:00:00Z", "2024-01-02T12:00:00Z");
+    check("2024-01-01T00:00:00Z/P1DT2H", "2024-01-01T00:00:00Z", "2024-01-02T02:00:00Z");
+    check("PT1H/2024-01-01T00:00:00Z", "2023-12-31T23:00:00Z", "2024-01-01T00:00:00Z");
+    check("2024-02-28T23:00:00.500+01:00/PT0.5S", "2024-02-28T22:00:00.500Z", "2024-02-28T22:00:01.000Z");
+    check("2024-01-01T00:00:00Z/-P1D", "2024-01-01T00:00:00Z", "2023-12-31T00:00:00Z");
+    check("2024-01-01T00:00:00Z/P1W", "2024-01-01T00:00:00Z", "2024-01-08T00:00:00Z");
+    check("-PT1H/2024-01-01T00:00:00Z", "2024-01-01T01:00:00Z", "2024-01-01T00:00:00Z");
+
+    EXPECT_EQ(ISODateTime::get_iso_interval(Format::utc_iso_date_time, {utc("2024-01-01T00:00:00Z"), utc("2024-12-31T23:59:59Z")}),
+              "2024-01-01T00:00:00Z/2024-12-31T23:59:59Z");
+    EXPECT_EQ(ISODateTime::get_iso_interval(Format::utc_iso_date, {utc("2024-01-01T12:00:00Z"), utc("2024-02-29T12:00:00Z")}),
+              "2024-01-01/2024-02-29");
+}
+
+TEST(Interval, RejectsMalformedText)
+{
+    for (const char* text : {"", "/", "2024-01-01T00:00:00Z", "2024-01-01T00:00:00Z/", "/2024-01-01T00:00:00Z",
+                             "P1D/P1D", "P1D", "2024-01-01T00:00:00Z/P1Y", "P1M/2024-01-01T00:00:00Z",
+                             "2024-01-01T00:00:00Z/2024-13-01T00:00:00Z", "2024-01-01T00:00:00Z//2024-01-02T00:00:00Z",
+                             "2024-01-01T00:00:00Z 2024-01-02T00:00:00Z", "2024-01-01T00:00:00Z/2024-01-02T00:00:00Z/PT1H",
+                             // The computed end is outside the clock's range
+                             "2262-04-11T00:00:00Z/P1D", "P1D/1677-09-21T12:00:00Z", "-P106751DT23H47M16.854775808S/2024-01-01T00:00:00Z"}) {
+        EXPECT_FALSE(ISODateTime::parse_iso_interval(text)) << '"' << text << '"';
+    }
+}
+
+TEST(Interval, ShortBufferAndUnrenderableEnds)
+{
+    const ISODateTime::Interval interval{utc("2024-01-01T00:00:00Z"), utc("2024-01-02T00:00:00Z")};
+    char buffer[ISODateTime::iso_interval_max_length];
+    EXPECT_EQ(ISODateTime::format_iso_interval(Format::utc_iso_date_time, buffer, 40, interval), 0U);
+    EXPECT_EQ(ISODateTime::format_iso_interval(Format::utc_iso_date_time, buffer, 41, interval), 41U);
+    EXPECT_EQ(ISODateTime::format_iso_interval(Format::iso_date_timestamp_ns_offset, buffer, sizeof(buffer), interval), sizeof(buffer));
+    EXPECT_EQ(ISODateTime::format_iso_interval(Format::utc_iso_date_time, nullptr, sizeof(buffer), interval), 0U);
+}
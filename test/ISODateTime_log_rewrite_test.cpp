@@ -0,0 +1,250 @@
+//
+// rewrite_log_timestamps against a line-by-line reference rewrite.
+//
+// A generated log mixes local, offset and UTC timestamps at 0, 3, 6 and 9 fraction digits with
+// lines that have none, invalid ones, or text that only resembles one. The reference finds the
+// first timestamp of each line with std::regex, converts it with parse_iso and writes it back
+// with format; the rewriter's output must match it byte for byte for every thread count and
+// for chunk sizes small enough to put a chunk boundary after almost every line.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <string>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+
+namespace {
+
+/**
+ * @brief The expected output of a rewrite and its counts.
+ */
+struct reference_rewrite {
+    std::string text;
+    std::uint64_t lines = 0;
+    std::uint64_t converted = 0;
+};
+
+/**
+ * @brief Rewrite text one line at a time with parse_iso and format.
+ * @param column Byte offset of the timestamp in every line, or ISODateTime::scan_for_timestamp.
+ */
+reference_rewrite rewrite_reference(const std::string& text, std::size_t column)
+{
+    // Not followed by another digit, as a timestamp inside a longer number is none
+    static const std::regex timestamp(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d{9}|\.\d{6}|\.\d{3})?(Z|[+-]\d{2}:\d{2})?(?!\d))");
+    reference_rewrite result;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        const std::size_t newline = text.find('\n', begin);
+        const std::size_t end = newline == std::string::npos ? text.size() : newline;
+        const std::string line = text.substr(begin, end - begin);
+        const std::string terminator = newline == std::string::npos ? "" : "\n";
+        begin = end + terminator.size();
+        ++result.lines;
+
+        std::smatch match;
+        bool found = false;
+        std::size_t position = 0;
+        if (column == ISODateTime::scan_for_timestamp) {
+            found = std::regex_search(line, match, timestamp);
+            position = found ? static_cast<std::size_t>(match.position(0)) : 0;
+        } else if (column < line.size()) {
+            found = std::regex_search(line.begin() + static_cast<std::ptrdiff_t>(column), line.end(), match, timestamp,
+                                      std::regex_constants::match_continuous);
+            position = column;
+        }
+        const std::string token = found ? match.str(0) : std::string();
+        const auto parsed = found && token.back() != 'Z' ? ISODateTime::parse_iso(token) : std::nullopt;
+        if (!parsed) {
+            result.text += line + terminator;
+            continue;
+        }
+        const std::size_t fraction_digits = match.length(1) == 0 ? 0 : static_cast<std::size_t>(match.length(1)) - 1;
+        const Format format = fraction_digits == 0 ? Format::utc_iso_date_time
+                              : fraction_digits == 3 ? Format::utc_iso_date_timestamp
+                              : fraction_digits == 6 ? Format::utc_iso_date_timestamp_us
+                                                     : Format::utc_iso_date_timestamp_ns;
+        char buffer[64];
+        const std::size_t length = ISODateTime::format(format, buffer, sizeof(buffer), *parsed);
+        result.text += line.substr(0, position) + std::string(buffer, length) + line.substr(position + token.size()) + terminator;
+        ++result.converted;
+    }
+    return result;
+}
+
+/**
+ * @brief Random log lines around the timestamps a rewrite has to handle.
+ */
+class random_log {
+public:
+    explicit random_log(std::uint64_t seed) : engine_(seed) {}
+
+    std::string timestamp(bool with_designator)
+    {
+        // 1971 to 2099, with DST gaps and folds hit often enough by drawing whole hours near 02:00
+        std::uniform_int_distribution<std::int64_t> seconds(31536000LL, 4102444799LL);
+        std::int64_t t = seconds(engine_);
+        if (engine_() % 4 == 0)
+            t -= t % 1800;
+        const time_point tp(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(t) + std::chrono::nanoseconds(engine_() % 1000000000)));
+        constexpr Format local[] = {Format::iso_date_time, Format::iso_date_timestamp, Format::iso_date_timestamp_us, Format::iso_date_timestamp_ns};
+        constexpr Format utc[] = {Format::utc_iso_date_time, Format::utc_iso_date_timestamp, Format::utc_iso_date_timestamp_us, Format::utc_iso_date_timestamp_ns};
+        constexpr Format offset[] = {Format::iso_date_time_offset, Format::iso_date_timestamp_offset, Format::iso_date_timestamp_us_offset, Format::iso_date_timestamp_ns_offset};
+        const std::size_t precision = engine_() % 4;
+        const Format format = !with_designator ? local[precision] : engine_() % 2 ? utc[precision] : offset[precision];
+        char buffer[64];
+        return {buffer, ISODateTime::format(format, buffer, sizeof(buffer), tp)};
+    }
+
+    std::string line()
+    {
+        static const char* const prefixes[] = {"", "I ", "[main] INFO TestRunner started at ", "pid=12345 ", "T", "2024-01-01 ",
+                                               "WARN 0123456789T ", "ab-cd-efTgh:ij:kl "};
+        static const char* const suffixes[] = {"", " request done", " status=200 latency=12ms", " 42", "Tail"};
+        const std::string prefix = prefixes[engine_() % std::size(prefixes)];
+        const std::string suffix = suffixes[engine_() % std::size(suffixes)];
+        switch (engine_() % 10) {
+            case 0: return "";
+            case 1: return prefix + "no timestamp here" + suffix;
+            case 2: return prefix + "2024-13-01T00:00:00 then " + timestamp(false) + suffix;
+            case 3: return prefix + "2024-01-01T00:00:00+24:00" + suffix;
+            case 4: return prefix + timestamp(false) + " and " + timestamp(false) + suffix;
+            case 5:
+            case 6: return prefix + timestamp(true) + suffix;
+            default: return prefix + timestamp(false) + suffix;
+        }
+    }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+/**
+ * @brief A file under the test temporary directory, removed again at the end of the test.
+ */
+class temporary_file {
+public:
+    explicit temporary_file(const std::string& name) : path_(::testing::TempDir() + "isodatetime_" + name) {}
+    ~temporary_file() { std::remove(path_.c_str()); }
+    temporary_file(const temporary_file&) = delete;
+    temporary_file& operator=(const temporary_file&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    void write(const std::string& text) const
+    {
+        std::ofstream(path_, std::ios::binary) << text;
+    }
+
+    std::string read() const
+    {
+        std::ifstream stream(path_, std::ios::binary);
+        return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    }
+
+private:
+    std::string path_;
+};
+
+void expect_rewrite_matches_reference(const std::string& log, std::size_t column)
+{
+    const temporary_file input("rewrite_input.log");
+    const temporary_file output("rewrite_output.log");
+    input.write(log);
+    const reference_rewrite expected = rewrite_reference(log, column);
+    ASSERT_GT(expected.converted, 0U);
+
+    for (const unsigned threads : {1U, 3U}) {
+        for (const std::size_t chunk_size : {std::size_t{1}, std::size_t{100}, std::size_t{4096}, std::size_t{0}}) {
+            const auto result = ISODateTime::rewrite_log_timestamps(input.path(), output.path(), {column, threads, chunk_size});
+            ASSERT_TRUE(result.ok);
+            EXPECT_EQ(result.lines, expected.lines) << threads << " threads, chunk " << chunk_size;
+            EXPECT_EQ(result.converted, expected.converted) << threads << " threads, chunk " << chunk_size;
+            EXPECT_EQ(result.bytes_written, expected.text.size()) << threads << " threads, chunk " << chunk_size;
+            // Compare line by line first so a failure names the line
+            const std::string actual = output.read();
+            if (actual != expected.text) {
+                std::size_t offset = 0;
+                while (offset < actual.size() && offset < expected.text.size() && actual[offset] == expected.text[offset])
+                    ++offset;
+                const std::size_t line_start = expected.text.rfind('\n', offset) == std::string::npos ? 0 : expected.text.rfind('\n', offset) + 1;
+                ADD_FAILURE() << threads << " threads, chunk " << chunk_size << ": first difference in\n  expected: "
+                              << expected.text.substr(line_start, expected.text.find('\n', offset) - line_start) << "\n  actual:   "
+                              << actual.substr(line_start, actual.find('\n', offset) - line_start);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(LogRewrite, ScanningMatchesReference)
+{
+    random_log log(1);
+    std::string text;
+    for (int i = 0; i < 3000; ++i)
+        text += log.line() + '\n';
+    // A last line without a newline
+    text += log.line();
+    expect_rewrite_matches_reference(text, ISODateTime::scan_for_timestamp);
+}
+
+TEST(LogRewrite, ScanningMatchesReferenceWithTheOffsetCache)
+{
+    ISODateTime::enable_local_offset_cache();
+    random_log log(2);
+    std::string text;
+    for (int i = 0; i < 3000; ++i)
+        text += log.line() + '\n';
+    expect_rewrite_matches_reference(text, ISODateTime::scan_for_timestamp);
+    ISODateTime::disable_local_offset_cache();
+}
+
+TEST(LogRewrite, ColumnMatchesReference)
+{
+    // Most lines carry the timestamp at column 4; the rest have it elsewhere or are too short
+    random_log log(3);
+    std::string text;
+    for (int i = 0; i < 3000; ++i) {
+        switch (i % 7) {
+            case 0: text += "abc\n"; break;
+            case 1: text += log.line() + '\n'; break;
+            default: text += "[" + std::to_string(i % 10) + "] " + log.timestamp(i % 3 == 0) + " message\n"; break;
+        }
+    }
+    expect_rewrite_matches_reference(text, 4);
+}
+
+TEST(LogRewrite, UtcOnlyLogIsCopiedUnchanged)
+{
+    const temporary_file input("utc_input.log");
+    const temporary_file output("utc_output.log");
+    random_log log(4);
+    std::string text;
+    for (int i = 0; i < 1000; ++i)
+        text += "x " + log.timestamp(true).substr(0, 19) + "Z done\n";
+    input.write(text);
+    const auto result = ISODateTime::rewrite_log_timestamps(input.path(), output.path(), {ISODateTime::scan_for_timestamp, 2, 64});
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.lines, 1000U);
+    EXPECT_EQ(result.converted, 0U);
+    EXPECT_EQ(output.read(), text);
+}
+
+TEST(LogRewrite, RejectsBadPaths)
+{
+    const temporary_file input("paths_input.log");
+    input.write("2024-01-01T00:00:00 x\n");
+    EXPECT_FALSE(ISODateTime::rewrite_log_timestamps(input.path(), input.path()).ok);
+    EXPECT_FALSE(ISODateTime::rewrite_log_timestamps(input.path() + ".missing", input.path() + ".out").ok);
+    EXPECT_FALSE(ISODateTime::rewrite_log_timestamps(input.path(), ::testing::TempDir() + "no_such_directory/out.log").ok);
+}
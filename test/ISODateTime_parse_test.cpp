@@ -0,0 +1,221 @@
+//
+// Round trips between the formatters and parse_iso / parse_utc_iso.
+//
+// Every Format is rendered for random times across the range of system_clock and parsed back;
+// the result must equal the input truncated to the Format's precision (or, for local text
+// without an offset, render to the same text again). Leap days, the 0000/9999 year bounds and
+// a list of malformed inputs are checked explicitly. ctest runs this with TZ=Europe/Paris, so
+// the local cases cross DST transitions.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+
+namespace {
+
+/**
+ * @brief Random times over the years system_clock can represent, at nanosecond resolution.
+ */
+class random_times {
+public:
+    explicit random_times(std::uint64_t seed) : engine_(seed) {}
+
+    time_point next()
+    {
+        // 1678-01-01 to 2261-12-31, clear of the clock's limits
+        std::uniform_int_distribution<std::int64_t> seconds(-9214646400LL, 9214559999LL);
+        std::uniform_int_distribution<std::int64_t> nanoseconds(0, 999999999);
+        return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(seconds(engine_)) + std::chrono::nanoseconds(nanoseconds(engine_))));
+    }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+using days = std::chrono::duration<std::int64_t, std::ratio<86400>>;
+
+/**
+ * @brief The time a UTC or offset Format's text names: the input truncated to its precision.
+ */
+time_point truncated(Format format, const time_point& t)
+{
+    switch (format) {
+        case Format::utc_iso_date: return std::chrono::floor<days>(t);
+        case Format::utc_iso_date_time:
+        case Format::iso_date_time_offset: return std::chrono::floor<std::chrono::seconds>(t);
+        case Format::utc_iso_date_timestamp:
+        case Format::iso_date_timestamp_offset: return std::chrono::floor<std::chrono::milliseconds>(t);
+        case Format::utc_iso_date_timestamp_us:
+        case Format::iso_date_timestamp_us_offset: return std::chrono::floor<std::chrono::microseconds>(t);
+        default: return std::chrono::floor<std::chrono::nanoseconds>(t);
+    }
+}
+
+std::string render(Format format, const time_point& t)
+{
+    char buffer[64];
+    const std::size_t length = ISODateTime::format(format, buffer, sizeof(buffer), t);
+    return {buffer, length};
+}
+
+bool is_utc(Format format)
+{
+    return format >= Format::utc_iso_date && format <= Format::utc_iso_date_timestamp_ns;
+}
+
+bool has_offset(Format format)
+{
+    return format >= Format::iso_date_time_offset;
+}
+
+} // namespace
+
+TEST(ParseRoundTrip, UtcFormatsGiveBackTheTruncatedTime)
+{
+    random_times times(1);
+    for (int i = 0; i < 20000; ++i) {
+        const auto t = times.next();
+        for (std::size_t f = 0; f < ISODateTime::format_count; ++f) {
+            const auto format = static_cast<Format>(f);
+            if (!is_utc(format))
+                continue;
+            const std::string text = render(format, t);
+            ASSERT_EQ(text.size(), ISODateTime::formatted_length(format));
+            const auto parsed = ISODateTime::parse_utc_iso(text);
+            ASSERT_TRUE(parsed.has_value()) << text;
+            EXPECT_EQ(*parsed, truncated(format, t)) << text;
+            // 'Z' text means UTC to parse_iso too
+            if (text.back() == 'Z') {
+                EXPECT_EQ(ISODateTime::parse_iso(text), parsed) << text;
+            }
+        }
+    }
+}
+
+TEST(ParseRoundTrip, OffsetFormatsGiveBackTheTruncatedTime)
+{
+    const time_point standard_time(days(ISODateTime::days_from_civil(1912, 1, 1)));
+    random_times times(2);
+    for (int i = 0; i < 20000; ++i) {
+        const auto t = times.next();
+        for (std::size_t f = 0; f < ISODateTime::format_count; ++f) {
+            const auto format = static_cast<Format>(f);
+            if (!has_offset(format))
+                continue;
+            const std::string text = render(format, t);
+            const auto parsed = ISODateTime::parse_iso(text);
+            ASSERT_TRUE(parsed.has_value()) << text;
+            // Local mean time offsets (Paris until 1911) carry seconds that +HH:MM drops
+            if (t >= standard_time) {
+                EXPECT_EQ(*parsed, truncated(format, t)) << text;
+            } else {
+                EXPECT_LT(std::chrono::abs(*parsed - truncated(format, t)), std::chrono::minutes(1)) << text;
+            }
+            EXPECT_EQ(ISODateTime::parse_utc_iso(text), parsed) << text;
+        }
+    }
+}
+
+TEST(ParseRoundTrip, LocalTextRendersTheSameAfterParsing)
+{
+    // Text in a DST fold names two instants; either one renders back to the same text
+    random_times times(3);
+    for (int i = 0; i < 20000; ++i) {
+        const auto t = times.next();
+        for (const Format format : {Format::iso_date_time, Format::iso_date_timestamp, Format::iso_date_timestamp_us, Format::iso_date_timestamp_ns}) {
+            const std::string text = render(format, t);
+            const auto parsed = ISODateTime::parse_iso(text);
+            ASSERT_TRUE(parsed.has_value()) << text;
+            EXPECT_EQ(render(format, *parsed), text);
+        }
+    }
+}
+
+TEST(ParseRoundTrip, EveryDayAroundLeapYears)
+{
+    // Every day from 1896 (before the 1900 non-leap year) to 2104, through 2000 and 2100
+    for (std::int64_t day = ISODateTime::days_from_civil(1896, 1, 1); day <= ISODateTime::days_from_civil(2104, 12, 31); ++day) {
+        const time_point t(std::chrono::duration_cast<time_point::duration>(days(day)));
+        const std::string text = render(Format::utc_iso_date, t);
+        EXPECT_EQ(ISODateTime::parse_utc_iso(text), t) << text;
+    }
+}
+
+TEST(ParseValidation, LeapDays)
+{
+    EXPECT_TRUE(ISODateTime::parse_utc_iso("2024-02-29"));
+    EXPECT_TRUE(ISODateTime::parse_utc_iso("2000-02-29T12:00:00Z"));
+    EXPECT_TRUE(ISODateTime::parse_utc_iso("1904-02-29"));
+    EXPECT_FALSE(ISODateTime::parse_utc_iso("2023-02-29"));
+    EXPECT_FALSE(ISODateTime::parse_utc_iso("1900-02-29"));
+    EXPECT_FALSE(ISODateTime::parse_utc_iso("2100-02-29T00:00:00Z"));
+    EXPECT_FALSE(ISODateTime::parse_utc_iso("2024-02-30"));
+    EXPECT_FALSE(ISODateTime::parse_iso("2023-02-29T00:00:00"));
+}
+
+TEST(ParseValidation, YearBounds)
+{
+    using seconds_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+    // 0000-01-01T00:00:00Z and 9999-12-31T23:59:59Z, the ends of the fixed-width year
+    const seconds_point first(std::chrono::seconds(ISODateTime::days_from_civil(0, 1, 1) * 86400));
+    const seconds_point last(std::chrono::seconds(ISODateTime::days_from_civil(9999, 12, 31) * 86400 + 86399));
+    const auto first_text = ISODateTime::make_utc_iso<Format::utc_iso_date_time>(first);
+    const auto last_text = ISODateTime::make_utc_iso<Format::utc_iso_date_time>(last);
+    EXPECT_EQ(std::string_view(first_text.data(), first_text.size()), "0000-01-01T00:00:00Z");
+    EXPECT_EQ(std::string_view(last_text.data(), last_text.size()), "9999-12-31T23:59:59Z");
+
+    // Years the clock can represent round-trip; others are rejected rather than wrapped
+    constexpr auto lowest = std::chrono::duration_cast<std::chrono::seconds>(time_point::duration::min()).count();
+    constexpr auto highest = std::chrono::duration_cast<std::chrono::seconds>(time_point::duration::max()).count();
+    const auto first_parsed = ISODateTime::parse_utc_iso(std::string_view(first_text.data(), first_text.size()));
+    const auto last_parsed = ISODateTime::parse_utc_iso(std::string_view(last_text.data(), last_text.size()));
+    if (first.time_since_epoch().count() >= lowest) {
+        EXPECT_EQ(first_parsed, time_point(first));
+    } else {
+        EXPECT_FALSE(first_parsed);
+    }
+    if (last.time_since_epoch().count() <= highest) {
+        EXPECT_EQ(last_parsed, time_point(last));
+    } else {
+        EXPECT_FALSE(last_parsed);
+    }
+
+    // The clock's own limits: the last whole second on either side parses exactly, one beyond does not
+    const std::string earliest = render(Format::utc_iso_date_time, time_point(std::chrono::seconds(lowest)));
+    const std::string latest = render(Format::utc_iso_date_time, time_point(std::chrono::seconds(highest)));
+    EXPECT_EQ(ISODateTime::parse_utc_iso(earliest), time_point(std::chrono::seconds(lowest))) << earliest;
+    EXPECT_EQ(ISODateTime::parse_utc_iso(latest), time_point(std::chrono::seconds(highest))) << latest;
+    if (time_point::duration::period::den == 1000000000) {
+        // The nanosecond clock ends at 1677-09-21T00:12:43.145224192Z and 2262-04-11T23:47:16.854775807Z
+        EXPECT_FALSE(ISODateTime::parse_utc_iso("1677-09-21T00:12:43Z"));
+        EXPECT_FALSE(ISODateTime::parse_utc_iso("2262-04-11T23:47:17Z"));
+        EXPECT_TRUE(ISODateTime::parse_utc_iso("2262-04-11T23:47:16.854775807Z"));
+        EXPECT_FALSE(ISODateTime::parse_utc_iso("2262-04-11T23:47:16.854775808Z"));
+        EXPECT_FALSE(ISODateTime::parse_iso("2262-04-12T01:47:17.000+02:00"));
+        EXPECT_TRUE(ISODateTime::parse_iso("2262-04-12T01:47:16.000+02:00"));
+    }
+}
+
+TEST(ParseValidation, RejectsMalformedText)
+{
+    for (const char* text : {"", "2024", "2024-01", "2024-1-01", "2024-01-1", " 2024-01-01", "2024-01-01 ", "2024/01/01",
+                             "2024-00-10", "2024-13-01", "2024-01-00", "2024-01-32", "2024-04-31",
+                             "2024-01-01T", "2024-01-01 00:00:00", "2024-01-01t00:00:00", "2024-01-01T0:00:00",
+                             "2024-01-01T24:00:00Z", "2024-01-01T23:60:00Z", "2024-01-01T23:59:60Z",
+                             "2024-01-01T00:00:00.Z", "2024-01-01T00:00:00.0Z", "2024-01-01T00:00:00.00Z",
+                             "2024-01-01T00:00:00.0000Z", "2024-01-01T00:00:00.1234567890Z", "2024-01-01T00:00:00ZZ",
+                             "2024-01-01T00:00:00z", "2024-01-01T00:00:00+24:00", "2024-01-01T00:00:00+05:60",
+                             "2024-01-01T00:00:00+0500", "2024-01-01T00:00:00+05", "2024-01-01T00:00:00.000+05:30Z",
+                             "2O24-01-01", "2024-01-01T00:00:0a", "+2024-01-01", "-2024-01-01"}) {
+        EXPECT_FALSE(ISODateTime::parse_iso(text)) << '"' << text << '"';
+        EXPECT_FALSE(ISODateTime::parse_utc_iso(text)) << '"' << text << '"';
+    }
+}
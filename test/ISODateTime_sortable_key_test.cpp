@@ -0,0 +1,164 @@
+//
+// sortable_key and sortable_keys: keys must sort like the times their text names.
+//
+// Random times are rendered in every Format and sorted; the keys must never decrease along the
+// sorted order and must increase wherever the times differ by a microsecond or more. 'Z' and
+// +HH:MM text of one instant must get one key, and sortable_keys must agree with sortable_key
+// record by record.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+
+namespace {
+
+std::vector<time_point> random_sorted_times(std::uint64_t seed, std::size_t count)
+{
+    // 1912 (whole-minute offsets in every zone tested) to 2261, at nanosecond resolution, with
+    // some near-duplicates so sub-microsecond ties occur
+    std::mt19937_64 engine(seed);
+    std::uniform_int_distribution<std::int64_t> seconds(-1834963200LL, 9214559999LL);
+    std::uniform_int_distribution<std::int64_t> nanoseconds(0, 999999999);
+    std::vector<time_point> times;
+    for (std::size_t i = 0; i < count; ++i) {
+        const time_point t(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(seconds(engine)) + std::chrono::nanoseconds(nanoseconds(engine))));
+        times.push_back(t);
+        if (i % 8 == 0)
+            times.push_back(t + std::chrono::duration_cast<time_point::duration>(std::chrono::nanoseconds(engine() % 2000)));
+    }
+    std::sort(times.begin(), times.end());
+    return times;
+}
+
+std::string render(Format format, const time_point& t)
+{
+    char buffer[64];
+    return {buffer, ISODateTime::format(format, buffer, sizeof(buffer), t)};
+}
+
+std::uint64_t key_of(const std::string& text)
+{
+    const auto key = ISODateTime::sortable_key(text);
+    EXPECT_TRUE(key.has_value()) << text;
+    return key.value_or(0);
+}
+
+} // namespace
+
+TEST(SortableKey, OrderMatchesTimeOrderInEveryFormat)
+{
+    const auto times = random_sorted_times(1, 20000);
+    for (std::size_t f = 0; f < ISODateTime::format_count; ++f) {
+        const auto format = static_cast<Format>(f);
+        // Local text is keyed by its wall clock, which steps back in autumn; render it in UTC terms instead
+        const bool local = format <= Format::iso_date_timestamp_ns;
+        const auto text_of = [&](const time_point& t) {
+            std::string text = render(local ? static_cast<Format>(f + 5) : format, t);
+            if (local && text.back() == 'Z')
+                text.pop_back();
+            return text;
+        };
+        std::string previous_text = text_of(times.front());
+        std::uint64_t previous_key = key_of(previous_text);
+        for (std::size_t i = 1; i < times.size(); ++i) {
+            const std::string text = text_of(times[i]);
+            const std::uint64_t key = key_of(text);
+            // Text is truncated to its precision, and keys to the microsecond
+            const auto parsed_previous = ISODateTime::parse_iso(previous_text + (local ? "Z" : ""));
+            const auto parsed = ISODateTime::parse_iso(text + (local ? "Z" : ""));
+            ASSERT_TRUE(parsed_previous && parsed) << text;
+            const auto previous_us = std::chrono::floor<std::chrono::microseconds>(*parsed_previous);
+            const auto current_us = std::chrono::floor<std::chrono::microseconds>(*parsed);
+            ASSERT_LE(previous_us, current_us) << previous_text << " then " << text;
+            if (previous_us < current_us) {
+                EXPECT_LT(previous_key, key) << previous_text << " then " << text;
+            } else {
+                EXPECT_EQ(previous_key, key) << previous_text << " then " << text;
+            }
+            previous_text = text;
+            previous_key = key;
+        }
+    }
+}
+
+TEST(SortableKey, UtcAndOffsetTextShareOneTimeline)
+{
+    // ctest runs with TZ=Europe/Paris, so the offset text carries +01:00 or +02:00
+    for (const auto& t : random_sorted_times(2, 20000)) {
+        EXPECT_EQ(key_of(render(Format::iso_date_time_offset, t)), key_of(render(Format::utc_iso_date_time, t)));
+        EXPECT_EQ(key_of(render(Format::iso_date_timestamp_offset, t)), key_of(render(Format::utc_iso_date_timestamp, t)));
+        EXPECT_EQ(key_of(render(Format::iso_date_timestamp_us_offset, t)), key_of(render(Format::utc_iso_date_timestamp_us, t)));
+        EXPECT_EQ(key_of(render(Format::iso_date_timestamp_ns_offset, t)), key_of(render(Format::utc_iso_date_timestamp_ns, t)));
+    }
+}
+
+TEST(SortableKey, LayoutAndBuckets)
+{
+    const std::uint64_t midnight = key_of("2024-02-29T00:00:00Z");
+    EXPECT_EQ(key_of("2024-02-29T00:00:00.000001Z") - midnight, 1U);
+    EXPECT_EQ(key_of("2024-02-29T00:00:00.000001999Z"), key_of("2024-02-29T00:00:00.000001Z"));
+    EXPECT_EQ(key_of("2024-02-29"), midnight);
+    EXPECT_EQ(key_of("2024-02-29Z"), midnight);
+    EXPECT_EQ(key_of("2024-02-29T13:00:00") >> 37, midnight >> 37);
+    EXPECT_EQ(key_of("2024-02-29T13:59:59.999Z") >> 32, key_of("2024-02-29T13:00:00Z") >> 32);
+    EXPECT_NE(key_of("2024-03-01T00:00:00Z") >> 37, midnight >> 37);
+    // Offsets move text across the day (and year) boundary before keying
+    EXPECT_EQ(key_of("2024-02-29T00:30:00+01:00"), key_of("2024-02-28T23:30:00Z"));
+    EXPECT_EQ(key_of("2024-12-31T20:00:00-05:00"), key_of("2025-01-01T01:00:00Z"));
+    EXPECT_EQ(key_of("2024-02-28T23:30:00.123456789-00:30"), key_of("2024-02-29T00:00:00.123456Z"));
+    // The whole 0000-9999 range keys, in order
+    EXPECT_LT(key_of("0000-01-01T00:00:00Z"), key_of("0000-01-01T00:00:00.000001Z"));
+    EXPECT_LT(key_of("9999-12-31T23:59:59.999998Z"), key_of("9999-12-31T23:59:59.999999Z"));
+    EXPECT_EQ(key_of("0000-01-01T01:00:00+01:00"), key_of("0000-01-01T00:00:00Z"));
+}
+
+TEST(SortableKey, RejectsMalformedText)
+{
+    for (const char* text : {"", "Z", "2024", "2024-02-30", "2023-02-29T00:00:00Z", "2024-13-01", "2024-00-01",
+                             "2024-01-00", "2024-01-01T24:00:00Z", "2024-01-01T00:60:00Z", "2024-01-01T00:00:60Z",
+                             "2024-01-01T00:00:00.0000Z", "2024-01-01T00:00:00.12Z", "2024-01-01 00:00:00Z",
+                             "2024/01/01", "2024-01-01T00:00:00.12a", "2024-01-01T00:00:00.123456a89Z",
+                             "2024-01-01T00:00:00+24:00", "2024-01-01T00:00:00+01:60", "2024-01-01T00:00:00+0a:00",
+                             "0000-01-01T00:00:00+00:01", "9999-12-31T23:59:59-00:01"}) {
+        EXPECT_FALSE(ISODateTime::sortable_key(text)) << '"' << text << '"';
+    }
+}
+
+TEST(SortableKeys, MatchSortableKeyPerRecord)
+{
+    // One fixed-width column with a separator byte, as in an export; every fifth record damaged
+    std::mt19937_64 engine(3);
+    for (const Format format : {Format::utc_iso_date, Format::utc_iso_date_timestamp, Format::utc_iso_date_timestamp_ns,
+                                Format::iso_date_time, Format::iso_date_timestamp_us_offset}) {
+        const std::size_t length = ISODateTime::formatted_length(format);
+        const std::size_t stride = length + 1;
+        std::string column;
+        std::vector<std::string> records;
+        for (const auto& t : random_sorted_times(4, 2000)) {
+            std::string record = render(format, t);
+            if (records.size() % 5 == 0)
+                record[engine() % length] = static_cast<char>(engine() % 256);
+            records.push_back(record);
+            column += record + ',';
+        }
+        std::vector<std::uint64_t> keys(records.size(), 1);
+        const std::size_t valid = ISODateTime::sortable_keys(column.data(), stride, length, records.size(), keys.data());
+        std::size_t expected_valid = 0;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto expected = ISODateTime::sortable_key(records[i]);
+            EXPECT_EQ(keys[i], expected.value_or(0)) << '"' << records[i] << '"';
+            expected_valid += expected.has_value();
+        }
+        EXPECT_EQ(valid, expected_valid);
+        EXPECT_LT(expected_valid, records.size());
+    }
+}
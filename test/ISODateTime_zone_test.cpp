@@ -0,0 +1,157 @@
+//
+// Time zones: offsets at DST transitions and the text formatted in a zone.
+//
+// Offsets are checked one second before and at each transition of a year inside the TZif
+// table (2024) and of one past it (2200, from the POSIX rule at the end of the file), in
+// zones with forward, backward and 30-minute changes. Text formatted in a zone must parse back
+// to the same instant, and a buffer too small for it must be left untouched. The tests skip
+// when the system has no tzdata.
+//
+
+#include "ISODateTime.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using time_point = std::chrono::time_point<std::chrono::system_clock>;
+using Format = ISODateTime::Format;
+
+namespace {
+
+/**
+ * @brief A DST transition: the UTC instant it happens at and the offsets on either side.
+ */
+struct transition {
+    const char* zone;
+    const char* at; // UTC, as parse_utc_iso text
+    std::int32_t before; // seconds east of UTC one second before
+    std::int32_t after; // seconds east of UTC from the transition on
+};
+
+constexpr transition transitions[] = {
+    {"Europe/Paris", "2024-03-31T01:00:00Z", 3600, 7200},
+    {"Europe/Paris", "2024-10-27T01:00:00Z", 7200, 3600},
+    {"America/New_York", "2024-03-10T07:00:00Z", -18000, -14400},
+    {"America/New_York", "2024-11-03T06:00:00Z", -14400, -18000},
+    {"Australia/Lord_Howe", "2024-04-06T15:00:00Z", 39600, 37800},
+    {"Australia/Lord_Howe", "2024-10-05T15:30:00Z", 37800, 39600},
+    // Past the last transition in the files, from the POSIX TZ rule
+    {"Europe/Paris", "2200-03-30T01:00:00Z", 3600, 7200},
+    {"Europe/Paris", "2200-10-26T01:00:00Z", 7200, 3600},
+    {"America/New_York", "2200-03-09T07:00:00Z", -18000, -14400},
+    {"America/New_York", "2200-11-02T06:00:00Z", -14400, -18000},
+    {"Australia/Lord_Howe", "2200-04-05T15:00:00Z", 39600, 37800},
+    {"Australia/Lord_Howe", "2200-10-04T15:30:00Z", 37800, 39600},
+};
+
+constexpr const char* round_trip_zones[] = {"UTC", "Europe/Paris", "America/New_York", "America/St_Johns",
+                                            "Asia/Kolkata", "Australia/Lord_Howe"};
+
+std::string render(Format format, const ISODateTime::TimeZone& zone, const time_point& t)
+{
+    char buffer[64];
+    return {buffer, ISODateTime::format(format, zone, buffer, sizeof(buffer), t)};
+}
+
+} // namespace
+
+TEST(Zone, OffsetsAtDstTransitions)
+{
+    for (const auto& change : transitions) {
+        const auto zone = ISODateTime::load_zone(change.zone);
+        if (!zone)
+            GTEST_SKIP() << "no tzdata for " << change.zone;
+        const auto at = ISODateTime::parse_utc_iso(change.at);
+        ASSERT_TRUE(at.has_value()) << change.at;
+        EXPECT_EQ(ISODateTime::utc_offset(*zone, *at - std::chrono::seconds(1)).count(), change.before) << change.zone << ' ' << change.at;
+        EXPECT_EQ(ISODateTime::utc_offset(*zone, *at - std::chrono::nanoseconds(1)).count(), change.before) << change.zone << ' ' << change.at;
+        EXPECT_EQ(ISODateTime::utc_offset(*zone, *at).count(), change.after) << change.zone << ' ' << change.at;
+        EXPECT_EQ(ISODateTime::utc_offset(*zone, *at + std::chrono::hours(1)).count(), change.after) << change.zone << ' ' << change.at;
+    }
+}
+
+TEST(Zone, TextAtDstTransitions)
+{
+    const auto paris = ISODateTime::load_zone("Europe/Paris");
+    const auto lord_howe = ISODateTime::load_zone("Australia/Lord_Howe");
+    if (!paris || !lord_howe)
+        GTEST_SKIP() << "no tzdata";
+    const auto at = [](const char* text) { return *ISODateTime::parse_utc_iso(text); };
+    // Spring forward skips 02:00-03:00; fall back repeats 02:00-03:00 with the other offset
+    EXPECT_EQ(render(Format::iso_date_time, *paris, at("2024-03-31T00:59:59Z")), "2024-03-31T01:59:59+01:00");
+    EXPECT_EQ(render(Format::iso_date_time, *paris, at("2024-03-31T01:00:00Z")), "2024-03-31T03:00:00+02:00");
+    EXPECT_EQ(render(Format::iso_date_time, *paris, at("2024-10-27T00:59:59Z")), "2024-10-27T02:59:59+02:00");
+    EXPECT_EQ(render(Format::iso_date_time, *paris, at("2024-10-27T01:00:00Z")), "2024-10-27T02:00:00+01:00");
+    EXPECT_EQ(render(Format::iso_date_timestamp, *lord_howe, at("2024-04-06T14:59:59.999Z")), "2024-04-07T01:59:59.999+11:00");
+    EXPECT_EQ(render(Format::iso_date_timestamp, *lord_howe, at("2024-04-06T15:00:00.000Z")), "2024-04-07T01:30:00.000+10:30");
+    // Dates carry no offset
+    EXPECT_EQ(render(Format::utc_iso_date, *lord_howe, at("2024-04-06T15:00:00Z")), "2024-04-07");
+}
+
+TEST(Zone, FormattedTextParsesBackToTheSameInstant)
+{
+    for (const char* name : round_trip_zones) {
+        const auto zone = ISODateTime::load_zone(name);
+        if (!zone)
+            GTEST_SKIP() << "no tzdata for " << name;
+        // Every ~9 days from 1906 to 2096, with a fraction so every precision is exercised
+        for (std::int64_t seconds = -2000000000LL; seconds < 4000000000LL; seconds += 777777) {
+            const time_point t = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(seconds)) + std::chrono::duration_cast<time_point::duration>(std::chrono::nanoseconds(123456789));
+            for (std::size_t f = 0; f < ISODateTime::format_count; ++f) {
+                const auto format = static_cast<Format>(f);
+                const std::string text = render(format, *zone, t);
+                ASSERT_EQ(text.size(), ISODateTime::zoned_length(format)) << name << ' ' << text;
+                if (text.size() == 10)
+                    continue;
+                const auto parsed = ISODateTime::parse_iso(text);
+                ASSERT_TRUE(parsed.has_value()) << name << ' ' << text;
+                const auto difference = std::chrono::floor<std::chrono::seconds>(*parsed) - std::chrono::floor<std::chrono::seconds>(t);
+                // Offsets with seconds (local mean time, St. John's until 1935) lose them in +HH:MM
+                if (ISODateTime::utc_offset(*zone, t).count() % 60 == 0) {
+                    EXPECT_EQ(difference.count(), 0) << name << ' ' << text;
+                } else {
+                    EXPECT_LT(std::chrono::abs(difference), std::chrono::minutes(1)) << name << ' ' << text;
+                }
+            }
+        }
+    }
+}
+
+TEST(Zone, ShortBufferIsLeftUntouched)
+{
+    const auto zone = ISODateTime::load_zone("Asia/Kolkata");
+    if (!zone)
+        GTEST_SKIP() << "no tzdata";
+    const time_point t(std::chrono::seconds(1700000000));
+    for (std::size_t f = 0; f < ISODateTime::format_count; ++f) {
+        const auto format = static_cast<Format>(f);
+        char buffer[64];
+        std::memset(buffer, '#', sizeof(buffer));
+        EXPECT_EQ(ISODateTime::format(format, *zone, buffer, ISODateTime::zoned_length(format) - 1, t), 0U);
+        EXPECT_EQ(std::string_view(buffer, sizeof(buffer)), std::string(sizeof(buffer), '#'));
+        const std::size_t length = ISODateTime::format(format, *zone, buffer, ISODateTime::zoned_length(format), t);
+        EXPECT_EQ(length, ISODateTime::zoned_length(format));
+        EXPECT_EQ(std::string_view(buffer + length, sizeof(buffer) - length), std::string(sizeof(buffer) - length, '#'));
+    }
+}
+
+TEST(Zone, LoadingAndEmptyHandles)
+{
+    EXPECT_FALSE(ISODateTime::load_zone("No/Such_Zone"));
+    EXPECT_FALSE(ISODateTime::load_zone("../../etc/passwd"));
+    const ISODateTime::TimeZone empty{nullptr};
+    char buffer[64];
+    EXPECT_EQ(ISODateTime::format(Format::iso_date_time, empty, buffer, sizeof(buffer), time_point()), 0U);
+    EXPECT_EQ(ISODateTime::utc_offset(empty, time_point()).count(), 0);
+
+    const auto zone = ISODateTime::load_zone("Europe/Paris");
+    if (!zone)
+        GTEST_SKIP() << "no tzdata";
+    EXPECT_EQ(ISODateTime::zone_name(*zone), "Europe/Paris");
+    // The cache hands out the same zone for the same name
+    EXPECT_EQ(ISODateTime::load_zone("Europe/Paris")->data, zone->data);
+}